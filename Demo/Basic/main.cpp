@@ -63,7 +63,6 @@ public:
 							  ":/shaders/core.vs",
 							  "./core.fs");
 	shader->setInt("texture1", 0);
-	shader->setVec4("ambient", 0.15f, 0.15f, 0.15f, 1.0f);
 
 	plainShader =
 		Shader::fromFile(4, 2, ":/shaders/plain.vs", ":/shaders/plain.fs");
@@ -92,6 +91,7 @@ public:
 	_scene->scale(0.2f);
 */
 	_scene = std::make_shared<Scene>(false);
+	_scene->ambient(glm::vec4(0.15f, 0.15f, 0.15f, 1.0f));
 	_scene->shaders(shader, plainShader);
 	_scene->debug(false);
 
@@ -260,6 +260,20 @@ public:
 											   .mass = 10000.f,
 										   }));
 
+	// Placed under a translated node, the crate lands on the ground at
+	// (3, 0.5, 8) and stays put once its body comes to rest
+	auto shelf = std::make_shared<ObjectNode>();
+	shelf->setTransform(glm::translate(glm::mat4(1.0f), glm::vec3(3.0f, 2.0f, 3.0f)));
+	shelf->meshes.push_back(ObjectGenerator::container({
+														   .position = glm::vec3(0.0f, 1.0f, 5.0f),
+														   .shader = shader,
+														   .textures = {texture1},
+														   .material = Material{.shininess = (float)(rand()%80)},
+														   .size = 0.5f,
+														   .mass = 10000.f,
+													   }));
+	_scene->add(shelf);
+
   }
 
   void keyEvent(int state, int key, int modifier, bool repeat) {
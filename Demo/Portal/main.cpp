@@ -82,6 +82,9 @@ public:
       return;
     }
 
+    // The tunnel walls are flagged as occluders in the JSON
+    scene->occlusionCulling(true);
+
     // Get camera configuration from loader
     auto cameraConfig = loader->getCameraConfig();
     
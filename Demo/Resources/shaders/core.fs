@@ -7,173 +7,168 @@ struct Material {
     float shininess;
 };
 
-struct DirLight {
+struct Light {
+    vec3 position;
+    int type;
     vec3 direction;
+    float range;
 
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
 
-    int on;
-};
-
-struct PointLight {
-    vec3 position;
-
     float constant;
     float linear;
     float quadratic;
 
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
-    int on;
-};
-
-struct SpotLight {
-    vec3 position;
-    vec3 direction;
     float cutOff;
     float outerCutOff;
-
-    float constant;
-    float linear;
-    float quadratic;
-
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
-    int on;
 };
 
-#define NR_POINT_LIGHTS 4
-#define NR_SPOT_LIGHTS 4
-#define NR_DIR_LIGHTS 4
+#define LIGHT_SPOT 2
+#define LIGHT_TEXELS 6
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
+flat in float InstanceShininess;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 viewPos;
+    float time;
+    vec4 ambient;  // Scene::ambient(), modulated by the directional lights
+} frame;
+
+layout (std140) uniform LightClusterData {
+    uvec4 grid;      // xyz = cluster counts, w = directional light count
+    vec4 slicing;    // x = depth scale, y = depth bias, z = near, w = far
+    vec4 viewport;   // x, y, width, height
+} clusters;
+
+uniform samplerBuffer lightData;     // LIGHT_TEXELS texels per light, directional lights first
+uniform usamplerBuffer clusterGrid;  // offset, count per cluster
+uniform usamplerBuffer lightIndices;
 
-uniform vec3 viewPos;
-uniform DirLight dirLight[NR_DIR_LIGHTS];
-uniform PointLight pointLights[NR_POINT_LIGHTS];
-uniform SpotLight spotLight[NR_SPOT_LIGHTS];
 uniform Material material;
-uniform vec4 ambient;
+uniform bool instanced;             // shininess comes from the instance buffer
+uniform float transparency;         // 1 - material opacity, 0 for instanced and batched draws
 
 
 // function prototypes
+Light FetchLight(int index);
+uvec2 FetchCluster();
 vec4 CalcAmbientLight();
-vec4 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir);
-vec4 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec4 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec4 CalcDirLight(Light light, vec3 normal, vec3 viewDir);
+vec4 CalcLocalLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir);
 
 void main()
 {
     // properties
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 viewDir = normalize(frame.viewPos - FragPos);
 
     // == =====================================================
-    // Our lighting is set up in 3 phases: directional, point lights and an optional flashlight
-    // For each phase, a calculate function is defined that calculates the corresponding color
-    // per lamp. In the main() function we take all the calculated colors and sum them up for
-    // this fragment's final color.
+    // Directional lights apply everywhere and modulate the ambient term.
+    // Point and spot lights are binned into view-space clusters on the CPU,
+    // so each fragment only walks the lights overlapping its own cluster.
     // == =====================================================
     // phase 1: directional lighting
     vec4 result = CalcAmbientLight();
 
-    for(int i = 0; i < NR_DIR_LIGHTS; i++){
-        if(dirLight[i].on == 1){
-            result *= CalcDirLight(dirLight[i], norm, viewDir);
-        }
+    for(int i = 0; i < int(clusters.grid.w); i++){
+        result *= CalcDirLight(FetchLight(i), norm, viewDir);
     }
 
-    // phase 2: point lights
-    for(int i = 0; i < NR_POINT_LIGHTS; i++){
-        if(pointLights[i].on == 1){
-            result += CalcPointLight(pointLights[i], norm, FragPos, viewDir);
-        }
+    // phase 2: point and spot lights of this cluster
+    uvec2 cluster = FetchCluster();
+    for(uint i = 0u; i < cluster.y; i++){
+        int index = int(texelFetch(lightIndices, int(cluster.x + i)).r);
+        result += CalcLocalLight(FetchLight(index), norm, FragPos, viewDir);
     }
 
-    // phase 3: spot light
-    for(int i = 0; i < NR_SPOT_LIGHTS; i++){
-        if(spotLight[i].on == 1){
-            result += CalcSpotLight(spotLight[i], norm, FragPos, viewDir);
-        }
-    }
+    FragColor = vec4(result.rgb, result.a * (1.0 - transparency));
+}
 
-    FragColor = result;
+Light FetchLight(int index)
+{
+    int base = index * LIGHT_TEXELS;
+    vec4 position = texelFetch(lightData, base);
+    vec4 direction = texelFetch(lightData, base + 1);
+    vec4 ambient = texelFetch(lightData, base + 2);
+    vec4 diffuse = texelFetch(lightData, base + 3);
+    vec4 specular = texelFetch(lightData, base + 4);
+    vec4 cone = texelFetch(lightData, base + 5);
+
+    Light light;
+    light.position = position.xyz;
+    light.type = int(position.w);
+    light.direction = direction.xyz;
+    light.range = direction.w;
+    light.ambient = ambient.rgb;
+    light.constant = ambient.w;
+    light.diffuse = diffuse.rgb;
+    light.linear = diffuse.w;
+    light.specular = specular.rgb;
+    light.quadratic = specular.w;
+    light.cutOff = cone.x;
+    light.outerCutOff = cone.y;
+    return light;
 }
 
-// calculates the color when using a directional light.
-vec4 CalcAmbientLight()
+// returns the light list (offset, count) of the cluster containing this fragment
+uvec2 FetchCluster()
 {
-    return ambient * texture(material.diffuse, TexCoords);
+    vec2 tile = (gl_FragCoord.xy - clusters.viewport.xy) / clusters.viewport.zw * vec2(clusters.grid.xy);
+    float depth = -(frame.view * vec4(FragPos, 1.0)).z;
+    float slice = floor(log(max(depth, clusters.slicing.z)) * clusters.slicing.x - clusters.slicing.y);
+
+    uvec3 cell = min(uvec3(uvec2(max(tile, vec2(0.0))), uint(max(slice, 0.0))), clusters.grid.xyz - 1u);
+    int index = int(cell.x + clusters.grid.x * (cell.y + clusters.grid.y * cell.z));
+    return texelFetch(clusterGrid, index).rg;
 }
 
-// calculates the color when using a directional light.
-vec4 CalcDirLight(DirLight light, vec3 normal, vec3 viewDir)
+// calculates the ambient color
+vec4 CalcAmbientLight()
 {
-    vec3 lightDir = normalize(-light.direction);
-    // diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    // specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    // combine results
-    vec4 ambientColor = vec4(light.ambient, 1.0) * texture(material.diffuse, TexCoords);
-    vec4 diffuseColor = vec4(light.diffuse, 1.0) * diff * texture(material.diffuse, TexCoords);
-//    vec3 specular = light.specular * spec * vec3(texture(material.specular, TexCoords));
-    return (ambientColor + diffuseColor);// + specular);
+    return frame.ambient * texture(material.diffuse, TexCoords);
 }
 
-// calculates the color when using a point light.
-vec4 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+// calculates the color when using a directional light.
+vec4 CalcDirLight(Light light, vec3 normal, vec3 viewDir)
 {
-    vec3 lightDir = normalize(light.position - fragPos);
+    vec3 lightDir = normalize(-light.direction);
     // diffuse shading
     float diff = max(dot(normal, lightDir), 0.0);
-    // specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    // attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
     // combine results
     vec4 ambientColor = vec4(light.ambient, 1.0) * texture(material.diffuse, TexCoords);
     vec4 diffuseColor = vec4(light.diffuse, 1.0) * diff * texture(material.diffuse, TexCoords);
-    vec4 specularColor = vec4(light.specular, 1.0) * spec * texture(material.specular, TexCoords);
-    ambientColor *= attenuation;
-    diffuseColor *= attenuation;
-    specularColor *= attenuation;
-    return (ambientColor + diffuseColor + specularColor);
+    return (ambientColor + diffuseColor);
 }
 
-// calculates the color when using a spot light.
-vec4 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+// calculates the color when using a point or spot light.
+vec4 CalcLocalLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir)
 {
     vec3 lightDir = normalize(light.position - fragPos);
     // diffuse shading
     float diff = max(dot(normal, lightDir), 0.0);
     // specular shading
     vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), instanced ? InstanceShininess : material.shininess);
     // attenuation
     float distance = length(light.position - fragPos);
     float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
     // spotlight intensity
-    float theta = dot(lightDir, normalize(-light.direction));
-    float epsilon = light.cutOff - light.outerCutOff;
-    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    if (light.type == LIGHT_SPOT) {
+        float theta = dot(lightDir, normalize(-light.direction));
+        float epsilon = light.cutOff - light.outerCutOff;
+        attenuation *= clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    }
     // combine results
     vec4 ambientColor = vec4(light.ambient, 1.0) * texture(material.diffuse, TexCoords);
     vec4 diffuseColor = vec4(light.diffuse, 1.0) * diff * texture(material.diffuse, TexCoords);
     vec4 specularColor = vec4(light.specular, 1.0) * spec * texture(material.specular, TexCoords);
-    ambientColor *= attenuation * intensity;
-    diffuseColor *= attenuation * intensity;
-    specularColor *= attenuation * intensity;
-    return (ambientColor + diffuseColor + specularColor);
-}
\ No newline at end of file
+    return (ambientColor + diffuseColor + specularColor) * attenuation;
+}
@@ -0,0 +1,63 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+layout (location = 5) in float aDrawId;    // static batch record, per vertex or per indirect instance
+layout (location = 6) in vec2 aNormalOct;  // octahedral normal of compact vertices
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 viewPos;
+    float time;
+    vec4 ambient;
+} frame;
+
+#define INSTANCE_TEXELS 5
+
+uniform mat4 model;
+
+uniform samplerBuffer instanceData;  // INSTANCE_TEXELS texels per instance: model, params
+uniform bool instanced;
+uniform int instanceBase;
+uniform bool batched;  // records come from aDrawId instead of the instance id
+uniform bool compactNormals;  // set from the mesh's vertex format, normals come from aNormalOct
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec2 TexCoords;
+flat out float InstanceShininess;
+
+// Must match depth.vs exactly, the opaque pass tests with GL_EQUAL after a pre-pass
+invariant gl_Position;
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main()
+{
+    mat4 world = model;
+    InstanceShininess = 0.0;
+    if (instanced) {
+        int record = batched ? int(aDrawId) : instanceBase + gl_InstanceID;
+        int base = record * INSTANCE_TEXELS;
+        world = mat4(texelFetch(instanceData, base),
+                     texelFetch(instanceData, base + 1),
+                     texelFetch(instanceData, base + 2),
+                     texelFetch(instanceData, base + 3));
+        InstanceShininess = texelFetch(instanceData, base + 4).x;
+    }
+
+    FragPos = vec3(world * vec4(aPos, 1.0));
+    vec3 normal = compactNormals ? octDecode(aNormalOct) : aNormal;
+    Normal = mat3(transpose(inverse(world))) * normal;
+    TexCoords = aTexCoords;
+
+    gl_Position = frame.viewProj * vec4(FragPos, 1.0);
+}
@@ -0,0 +1,124 @@
+#version 330 core
+#extension GL_ARB_compute_shader : require
+#extension GL_ARB_shader_storage_buffer_object : require
+
+// One invocation per static batch record, see render/GpuCulling.h
+layout (local_size_x = 64) in;
+
+struct Record {
+    vec4 boxMin;    // w = 1 while the draw is enabled
+    vec4 boxMax;    // w = 1 when the bounds are known
+    uvec4 firsts;   // first index per level of detail
+    uvec4 counts;   // index count per level, 0 past the last one
+    ivec4 draw;     // base vertex, group, group's first command, command inside the group
+};
+
+struct Command {
+    uint count;
+    uint instanceCount;
+    uint firstIndex;
+    int baseVertex;
+    uint baseInstance;
+};
+
+layout (std430) readonly buffer Records { Record records[]; };
+layout (std430) writeonly buffer Commands { Command commands[]; };
+layout (std430) buffer Counts { uint counts[]; };
+
+uniform mat4 viewProjection;
+uniform vec3 eye;
+uniform float lodScale;
+uniform vec3 lodThresholds;
+uniform int recordCount;
+uniform bool compact;
+
+// Max depth pyramid of the previous frame, tested with that frame's matrix
+uniform bool useHiZ;
+uniform sampler2D hiZ;
+uniform mat4 hiZViewProjection;
+uniform int hiZLevels;
+
+vec3 corner(Record record, int i)
+{
+    return vec3((i & 1) != 0 ? record.boxMax.x : record.boxMin.x,
+                (i & 2) != 0 ? record.boxMax.y : record.boxMin.y,
+                (i & 4) != 0 ? record.boxMax.z : record.boxMin.z);
+}
+
+bool inFrustum(Record record)
+{
+    // Outside when all corners are beyond the same clip plane
+    bvec3 allLow = bvec3(true), allHigh = bvec3(true);
+    for (int i = 0; i < 8; i++) {
+        vec4 clip = viewProjection * vec4(corner(record, i), 1.0);
+        allLow = allLow && lessThan(clip.xyz, vec3(-clip.w));
+        allHigh = allHigh && greaterThan(clip.xyz, vec3(clip.w));
+    }
+    return !any(allLow) && !any(allHigh);
+}
+
+bool behindHiZ(Record record)
+{
+    vec2 low = vec2(1.0), high = vec2(0.0);
+    float nearest = 1.0;
+    for (int i = 0; i < 8; i++) {
+        vec4 clip = hiZViewProjection * vec4(corner(record, i), 1.0);
+        // Reaching past the near plane, no screen rectangle to test
+        if (clip.w <= 0.0 || clip.z < -clip.w)
+            return false;
+        vec3 ndc = clip.xyz / clip.w;
+        low = min(low, ndc.xy * 0.5 + 0.5);
+        high = max(high, ndc.xy * 0.5 + 0.5);
+        nearest = min(nearest, ndc.z * 0.5 + 0.5);
+    }
+    low = clamp(low, 0.0, 1.0);
+    high = clamp(high, 0.0, 1.0);
+
+    // The level where the rectangle spans at most two texels each way
+    vec2 extent = (high - low) * vec2(textureSize(hiZ, 0));
+    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, hiZLevels - 1);
+    vec2 size = vec2(textureSize(hiZ, level));
+    ivec2 a = ivec2(clamp(low * size, vec2(0.0), size - 1.0));
+    ivec2 b = ivec2(clamp(high * size, vec2(0.0), size - 1.0));
+
+    float farthest = max(max(texelFetch(hiZ, a, level).r, texelFetch(hiZ, ivec2(b.x, a.y), level).r),
+                         max(texelFetch(hiZ, ivec2(a.x, b.y), level).r, texelFetch(hiZ, b, level).r));
+    return nearest > farthest;
+}
+
+void main()
+{
+    int id = int(gl_GlobalInvocationID.x);
+    if (id >= recordCount)
+        return;
+
+    Record record = records[id];
+    bool bounded = record.boxMax.w > 0.0;
+    bool visible = record.boxMin.w > 0.0 && (!bounded || (inFrustum(record) && !(useHiZ && behindHiZ(record))));
+
+    uint slot;
+    if (compact) {
+        if (!visible)
+            return;
+        slot = atomicAdd(counts[record.draw.y], 1u);
+    } else {
+        slot = uint(record.draw.w);
+    }
+
+    // Projected bounding sphere picks the level like the CPU path, without hysteresis
+    vec3 center = (record.boxMin.xyz + record.boxMax.xyz) * 0.5;
+    float radius = length(record.boxMax.xyz - record.boxMin.xyz) * 0.5;
+    float distance = length(center - eye);
+    float screenSize = bounded && distance > radius ? radius * lodScale / distance : 1e30;
+    int lod = 0;
+    while (lod < 3 && record.counts[lod + 1] != 0u && screenSize < lodThresholds[lod])
+        lod++;
+
+    Command command;
+    command.count = record.counts[lod];
+    command.instanceCount = visible ? 1u : 0u;
+    command.firstIndex = record.firsts[lod];
+    command.baseVertex = record.draw.x;
+    command.baseInstance = uint(id);
+    commands[uint(record.draw.z) + slot] = command;
+}
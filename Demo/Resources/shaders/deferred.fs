@@ -0,0 +1,171 @@
+#version 330 core
+// Lighting pass of the deferred path, shades like core.fs from the G-buffer
+out vec4 FragColor;
+
+struct Light {
+    vec3 position;
+    int type;
+    vec3 direction;
+    float range;
+
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    float constant;
+    float linear;
+    float quadratic;
+
+    float cutOff;
+    float outerCutOff;
+};
+
+#define LIGHT_SPOT 2
+#define LIGHT_TEXELS 6
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 viewPos;
+    float time;
+    vec4 ambient;  // set through Scene::ambient()
+} frame;
+
+layout (std140) uniform LightClusterData {
+    uvec4 grid;      // xyz = cluster counts, w = directional light count
+    vec4 slicing;    // x = depth scale, y = depth bias, z = near, w = far
+    vec4 viewport;   // x, y, width, height
+} clusters;
+
+uniform samplerBuffer lightData;     // LIGHT_TEXELS texels per light, directional lights first
+uniform usamplerBuffer clusterGrid;  // offset, count per cluster
+uniform usamplerBuffer lightIndices;
+
+uniform sampler2D albedo;   // rgb = diffuse, a = specular intensity
+uniform sampler2D surface;  // xy = octahedral normal, z = shininess
+uniform sampler2D depth;
+uniform mat4 inverseViewProjection;
+
+// function prototypes
+Light FetchLight(int index);
+uvec2 FetchCluster(vec3 fragPos);
+vec3 octDecode(vec2 e);
+vec4 CalcDirLight(Light light, vec3 normal, vec4 diffuseColor);
+vec4 CalcLocalLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir, vec4 diffuseColor, float specularColor,
+                    float shininess);
+
+void main()
+{
+    ivec2 texel = ivec2(gl_FragCoord.xy - clusters.viewport.xy);
+    float z = texelFetch(depth, texel, 0).r;
+    // Nothing was drawn here, leave it to the sky
+    if (z >= 1.0)
+        discard;
+    gl_FragDepth = z;
+
+    vec4 material = texelFetch(albedo, texel, 0);
+    vec3 params = texelFetch(surface, texel, 0).xyz;
+    vec4 diffuseColor = vec4(material.rgb, 1.0);
+
+    vec2 ndc = (gl_FragCoord.xy - clusters.viewport.xy) / clusters.viewport.zw * 2.0 - 1.0;
+    vec4 world = inverseViewProjection * vec4(ndc, z * 2.0 - 1.0, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+    vec3 norm = octDecode(params.xy);
+    vec3 viewDir = normalize(frame.viewPos - fragPos);
+
+    // phase 1: directional lights modulate the ambient term
+    vec4 result = frame.ambient * diffuseColor;
+    for(int i = 0; i < int(clusters.grid.w); i++){
+        result *= CalcDirLight(FetchLight(i), norm, diffuseColor);
+    }
+
+    // phase 2: point and spot lights of this cluster
+    uvec2 cluster = FetchCluster(fragPos);
+    for(uint i = 0u; i < cluster.y; i++){
+        int index = int(texelFetch(lightIndices, int(cluster.x + i)).r);
+        result += CalcLocalLight(FetchLight(index), norm, fragPos, viewDir, diffuseColor, material.a, params.z);
+    }
+
+    FragColor = result;
+}
+
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+Light FetchLight(int index)
+{
+    int base = index * LIGHT_TEXELS;
+    vec4 position = texelFetch(lightData, base);
+    vec4 direction = texelFetch(lightData, base + 1);
+    vec4 ambient = texelFetch(lightData, base + 2);
+    vec4 diffuse = texelFetch(lightData, base + 3);
+    vec4 specular = texelFetch(lightData, base + 4);
+    vec4 cone = texelFetch(lightData, base + 5);
+
+    Light light;
+    light.position = position.xyz;
+    light.type = int(position.w);
+    light.direction = direction.xyz;
+    light.range = direction.w;
+    light.ambient = ambient.rgb;
+    light.constant = ambient.w;
+    light.diffuse = diffuse.rgb;
+    light.linear = diffuse.w;
+    light.specular = specular.rgb;
+    light.quadratic = specular.w;
+    light.cutOff = cone.x;
+    light.outerCutOff = cone.y;
+    return light;
+}
+
+// returns the light list (offset, count) of the cluster containing this pixel
+uvec2 FetchCluster(vec3 fragPos)
+{
+    vec2 tile = (gl_FragCoord.xy - clusters.viewport.xy) / clusters.viewport.zw * vec2(clusters.grid.xy);
+    float depth = -(frame.view * vec4(fragPos, 1.0)).z;
+    float slice = floor(log(max(depth, clusters.slicing.z)) * clusters.slicing.x - clusters.slicing.y);
+
+    uvec3 cell = min(uvec3(uvec2(max(tile, vec2(0.0))), uint(max(slice, 0.0))), clusters.grid.xyz - 1u);
+    int index = int(cell.x + clusters.grid.x * (cell.y + clusters.grid.y * cell.z));
+    return texelFetch(clusterGrid, index).rg;
+}
+
+// calculates the color when using a directional light.
+vec4 CalcDirLight(Light light, vec3 normal, vec4 diffuseColor)
+{
+    vec3 lightDir = normalize(-light.direction);
+    float diff = max(dot(normal, lightDir), 0.0);
+    return vec4(light.ambient, 1.0) * diffuseColor + vec4(light.diffuse, 1.0) * diff * diffuseColor;
+}
+
+// calculates the color when using a point or spot light.
+vec4 CalcLocalLight(Light light, vec3 normal, vec3 fragPos, vec3 viewDir, vec4 diffuseColor, float specularColor,
+                    float shininess)
+{
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
+    // attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    // spotlight intensity
+    if (light.type == LIGHT_SPOT) {
+        float theta = dot(lightDir, normalize(-light.direction));
+        float epsilon = light.cutOff - light.outerCutOff;
+        attenuation *= clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    }
+    // combine results
+    vec4 ambientColor = vec4(light.ambient, 1.0) * diffuseColor;
+    vec4 diffuse = vec4(light.diffuse, 1.0) * diff * diffuseColor;
+    vec4 specular = vec4(light.specular, 1.0) * spec * specularColor;
+    return (ambientColor + diffuse + specular) * attenuation;
+}
@@ -0,0 +1,40 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 5) in float aDrawId;  // static batch record, per vertex or per indirect instance
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 viewPos;
+    float time;
+    vec4 ambient;
+} frame;
+
+#define INSTANCE_TEXELS 5
+
+uniform mat4 model;
+
+uniform samplerBuffer instanceData;
+uniform bool instanced;
+uniform int instanceBase;
+uniform bool batched;
+
+// Must match core.vs exactly, the opaque pass tests with GL_EQUAL
+invariant gl_Position;
+
+void main()
+{
+    mat4 world = model;
+    if (instanced) {
+        int record = batched ? int(aDrawId) : instanceBase + gl_InstanceID;
+        int base = record * INSTANCE_TEXELS;
+        world = mat4(texelFetch(instanceData, base),
+                     texelFetch(instanceData, base + 1),
+                     texelFetch(instanceData, base + 2),
+                     texelFetch(instanceData, base + 3));
+    }
+
+    vec3 fragPos = vec3(world * vec4(aPos, 1.0));
+    gl_Position = frame.viewProj * vec4(fragPos, 1.0);
+}
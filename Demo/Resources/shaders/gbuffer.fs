@@ -0,0 +1,32 @@
+#version 330 core
+// Paired with core.vs for the opaque pass of the deferred path, see render/GBuffer.h
+layout (location = 0) out vec4 Albedo;   // rgb = diffuse, a = specular intensity
+layout (location = 1) out vec4 Surface;  // xy = octahedral normal, z = shininess
+
+struct Material {
+    sampler2D diffuse;
+    sampler2D specular;
+    float shininess;
+};
+
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoords;
+flat in float InstanceShininess;
+
+uniform Material material;
+uniform bool instanced;  // shininess comes from the instance buffer
+
+vec2 octEncode(vec3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    if (n.z < 0.0)
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return n.xy;
+}
+
+void main()
+{
+    Albedo = vec4(texture(material.diffuse, TexCoords).rgb, texture(material.specular, TexCoords).r);
+    Surface = vec4(octEncode(normalize(Normal)), instanced ? InstanceShininess : material.shininess, 1.0);
+}
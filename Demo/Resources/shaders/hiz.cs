@@ -0,0 +1,31 @@
+#version 330 core
+#extension GL_ARB_compute_shader : require
+#extension GL_ARB_shader_image_load_store : require
+
+// One level of the max depth pyramid, see render/GpuCulling.h
+layout (local_size_x = 8, local_size_y = 8) in;
+
+uniform bool fromDepth;         // level 0 reads the copied depth buffer
+uniform sampler2D depthSource;
+layout (r32f) uniform readonly image2D source;
+layout (r32f) uniform writeonly image2D target;
+uniform vec2 sourceSize;
+uniform vec2 targetSize;
+
+float fetch(ivec2 p)
+{
+    p = min(p, ivec2(sourceSize) - 1);
+    return fromDepth ? texelFetch(depthSource, p, 0).r : imageLoad(source, p).r;
+}
+
+void main()
+{
+    ivec2 p = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(p, ivec2(targetSize))))
+        return;
+
+    // Farthest of the 2x2 texels below, odd sizes clamp to the last row and column
+    ivec2 s = p * 2;
+    float depth = max(max(fetch(s), fetch(s + ivec2(1, 0))), max(fetch(s + ivec2(0, 1)), fetch(s + ivec2(1, 1))));
+    imageStore(target, p, vec4(depth));
+}
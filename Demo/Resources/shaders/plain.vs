@@ -0,0 +1,22 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 viewPos;
+    float time;
+    vec4 ambient;
+} frame;
+
+uniform mat4 model;
+
+out vec3 Normal;
+
+void main()
+{
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    gl_Position = frame.viewProj * model * vec4(aPos, 1.0);
+}
@@ -1,12 +1,22 @@
 #version 330 core
 out vec4 FragColor;
 
-in vec2 TexCoords;
+in vec3 FragPos;
 
 uniform sampler2D portalTexture;
+// Placed the portal on screen when its view was rendered
+uniform mat4 portalViewProjection;
+// Screen rectangle (x0, y0, x1, y1) covered by the portal texture
+uniform vec4 portalRect;
+// Part of the pooled texture holding the view
+uniform vec2 portalScale;
 
 void main()
 {
-    FragColor = texture(portalTexture, TexCoords);
+    // Where this point of the portal was when the view was rendered: the same
+    // pixel for a fresh view, reprojected through the portal plane for a reused one
+    vec4 clip = portalViewProjection * vec4(FragPos, 1.0);
+    vec2 screen = clip.xy / clip.w * 0.5 + 0.5;
+    vec2 uv = (screen - portalRect.xy) / (portalRect.zw - portalRect.xy);
+    FragColor = texture(portalTexture, clamp(uv, 0.0, 1.0) * portalScale);
 }
-
@@ -0,0 +1,21 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProj;
+    vec3 viewPos;
+    float time;
+    vec4 ambient;
+} frame;
+
+out vec3 TexCoords;
+
+void main()
+{
+    TexCoords = aPos;
+    // remove translation from the view matrix so the sky follows the camera
+    vec4 pos = frame.projection * mat4(mat3(frame.view)) * vec4(aPos, 1.0);
+    gl_Position = pos.xyww;
+}
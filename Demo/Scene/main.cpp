@@ -9,6 +9,7 @@
 #include <render/Material.h>
 #include <render/Texture.h>
 #include <geometry/Object.h>
+#include <geometry/Scene.h>
 
 #include <render/DirectionalLight.h>
 #include <render/PointLight.h>
@@ -29,10 +30,14 @@ public:
 	camera = std::make_shared<Camera>(glm::vec3(1.0f, 0.0f, 3.0f),
 									  glm::vec3(0.0f, 1.0f, 0.0f), -110.f);
 	shader = Shader::fromFile(
-		4, 2, "/Users/cta/Development/personal/Omega/Demo/Basic/vertex_core.vs",
-		"/Users/cta/Development/personal/Omega/Demo/Basic/fragment_core.fs");
+		4, 2, "/Users/cta/Development/personal/Omega/Demo/Resources/shaders/core.vs",
+		"/Users/cta/Development/personal/Omega/Demo/Resources/shaders/core.fs");
 	shader->setInt("texture1", 0);
-	shader->setVec3("ambient", 0.05f, 0.05f, 0.05f);
+
+	plainShader = Shader::fromFile(
+		4, 2, "/Users/cta/Development/personal/Omega/Demo/Resources/shaders/plain.vs",
+		"/Users/cta/Development/personal/Omega/Demo/Resources/shaders/plain.fs");
+	plainShader->setInt("texture1", 0);
 
 	texture1 = std::make_shared<Texture>();
 	texture1->load(
@@ -43,9 +48,18 @@ public:
 		"/Users/cta/Development/personal/Omega/Demo/Basic/"
 		"container2_specular.png");
 
+	_scene = std::make_shared<Scene>(false);
+	_scene->ambient(glm::vec4(0.05f, 0.05f, 0.05f, 1.0f));
+	_scene->shaders(shader, plainShader);
+
+	auto idx = _scene->add(camera);
+
 	createLights();
 	generateCubes();
 
+	_scene->prepare();
+	_scene->setCurrentCamera(idx);
+
 	setCamera(camera);
   }
 
@@ -108,14 +122,14 @@ public:
 			.cutOff = glm::cos(glm::radians(12.5f)),
 			.outerCutOff = glm::cos(glm::radians(15.0f))});
 
-	lights_.push_back(dir_light);
+	_scene->add(dir_light);
 
-	lights_.push_back(point_light1);
-	lights_.push_back(point_light2);
-	lights_.push_back(point_light3);
-	lights_.push_back(point_light4);
+	_scene->add(point_light1);
+	_scene->add(point_light2);
+	_scene->add(point_light3);
+	_scene->add(point_light4);
 
-	lights_.push_back(spot_light);
+	_scene->add(spot_light);
   }
 
   void generateCubes() {
@@ -134,11 +148,10 @@ public:
 	  mat = glm::translate(mat, pos);
 	  mat = glm::rotate(mat, glm::radians(angle), glm::vec3(1.0f, 0.3f, 0.5f));
 
-	  object_list_.push_back(ObjectGenerator::box({.matrix = mat,
-													  .shader = shader,
-													  .textures = {texture1},
-													  .material = material,
-													  .lights = lights_}));
+	  _scene->add(ObjectGenerator::box({.matrix = mat,
+										   .shader = shader,
+										   .textures = {texture1},
+										   .material = material}));
 	}
   }
 
@@ -158,19 +171,17 @@ public:
   }
 
   bool render() {
-	for (auto object : object_list_) {
-	  object->render(camera);
-	}
+	_scene->render();
 	return Window::render();
   }
 
 private:
+  std::shared_ptr<Scene> _scene;
   std::shared_ptr<Shader> shader;
+  std::shared_ptr<Shader> plainShader;
   std::shared_ptr<Camera> camera;
   std::shared_ptr<Texture> texture1;
   std::shared_ptr<Texture> texture2;
-  std::vector<std::shared_ptr<Object>> object_list_;
-  std::vector<std::shared_ptr<Light>> lights_;
 };
 
 int main() {
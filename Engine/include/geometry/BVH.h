@@ -0,0 +1,69 @@
+#pragma once
+
+#include <system/Global.h>
+#include <geometry/Box.h>
+#include <geometry/Plane.h>
+#include <geometry/Sphere.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace omega {
+namespace geometry {
+
+/**
+ * BVH - Bounding volume hierarchy over a table of world bounds
+ * The tree stores slot indices into a bounds array owned by the caller, which
+ * must outlive it and keep its size until the next build(). Nodes are stored
+ * depth first in one array, so a node's left child directly follows it and
+ * every child has a higher index than its parent. build() sorts the slots into
+ * the tree, refit() only recomputes the boxes bottom up and is meant for slots
+ * that move every frame without changing the set.
+ */
+class OMEGA_EXPORT BVH {
+public:
+  static constexpr unsigned int MAX_LEAF_OBJECTS = 4;
+  static constexpr uint32_t NONE = ~0u;
+
+  using Frustum = std::array<Plane<float>, 6>;
+
+  void build(const std::vector<Box3<float>>& bounds, std::vector<uint32_t> slots);
+  void refit();
+  void clear();
+
+  // Appends every slot whose box touches the frustum
+  void cull(const Frustum& frustum, std::vector<uint32_t>& visible) const;
+
+  // Closest slot whose box is hit by the segment, t is the position along it
+  auto raycast(const Point3<float>& start, const Point3<float>& end, float* t) const -> uint32_t;
+
+  void query(const Box3<float>& box, std::vector<uint32_t>& result) const;
+  void query(const Sphere<float>& sphere, std::vector<uint32_t>& result) const;
+
+  auto empty() const -> bool { return nodes_.empty(); }
+  auto size() const -> size_t { return slots_.size(); }
+  auto bounds() const -> const Box3<float>&;
+
+private:
+  struct Node {
+    Box3<float> bounds;
+    unsigned int offset;  // right child for inner nodes, first slot for leaves
+    unsigned int count;   // 0 for inner nodes
+  };
+
+  auto buildNode(unsigned int first, unsigned int count) -> unsigned int;
+  void cullNode(unsigned int index, const Frustum& frustum, unsigned int planeMask, std::vector<uint32_t>& visible) const;
+  void appendLeaves(unsigned int index, std::vector<uint32_t>& visible) const;
+
+  static auto surfaceArea(const Box3<float>& box) -> float;
+
+  const std::vector<Box3<float>>* bounds_{nullptr};
+  std::vector<Node> nodes_;
+  std::vector<uint32_t> slots_;
+
+  // Root area at build time, refit rebuilds once the tree has degraded past it
+  float builtArea_{0.0f};
+};
+
+}  // namespace geometry
+}  // namespace omega
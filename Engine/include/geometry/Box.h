@@ -3,10 +3,11 @@
 #include <geometry/Math.h>
 #include <geometry/Point3.h>
 #include <geometry/Point2.h>
-#include <geometry/Matrix.h>
 #include <geometry/Sphere.h>
 #include <geometry/BoxBase.h>
 
+#include <limits>
+
 namespace omega {
 namespace geometry {
 template<class T>
@@ -367,6 +368,60 @@ inline T Box3<T>::getSqDistanceTPoint(const Point3<T> &refPt) const {
   return sqDist;
 }
 
+template<class T>
+inline bool Box3<T>::collideLine(const Point3<T> &start, const Point3<T> &end, T *t, Point3<T> *n) const {
+  // Slab test, tracking the axis that produced the latest entry
+  T tEnter = 0.0f;
+  T tExit = 1.0f;
+  int enterAxis = -1;
+  T enterSign = 0.0f;
+
+  for (unsigned int i = 0; i < 3; i++) {
+	const T delta = end[i] - start[i];
+	if (delta==0.0f) {
+	  if (start[i] < minExtents[i] || start[i] > maxExtents[i])
+		return false;
+	  continue;
+	}
+
+	T t0 = (minExtents[i] - start[i])/delta;
+	T t1 = (maxExtents[i] - start[i])/delta;
+	T sign = -1.0f;
+	if (t0 > t1) {
+	  T tmp = t0;
+	  t0 = t1;
+	  t1 = tmp;
+	  sign = 1.0f;
+	}
+
+	if (t0 > tEnter) {
+	  tEnter = t0;
+	  enterAxis = i;
+	  enterSign = sign;
+	}
+	if (t1 < tExit)
+	  tExit = t1;
+	if (tEnter > tExit)
+	  return false;
+  }
+
+  // Lines starting inside the box have no entry face
+  if (enterAxis < 0)
+	return false;
+
+  *t = tEnter;
+  n->set(0.0f, 0.0f, 0.0f);
+  (*n)[enterAxis] = enterSign;
+  return true;
+}
+
+template<class T>
+inline bool Box3<T>::collideLine(const Point3<T> &start, const Point3<T> &end) const {
+  T t;
+  Point3<T> n;
+  return isContained(start) || collideLine(start, end, &t, &n);
+}
+
 template<class T>
 inline void Box3<T>::extend(const Point3<T> &p) {
 #define EXTEND_AXIS(AXIS)    \
@@ -403,5 +458,16 @@ template<class T>
 inline bool Box3<T>::operator!=(const Box3 &b) const {
   return !minExtents.equal(b.minExtents) || !maxExtents.equal(b.maxExtents);
 }
+
+template<class T>
+const Box3<T> Box3<T>::Invalid(std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max(),
+							   std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest());
+
+template<class T>
+const Box3<T> Box3<T>::Max(std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(),
+						   std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max());
+
+template<class T>
+const Box3<T> Box3<T>::Zero(0, 0, 0, 0, 0, 0);
 };
 }
\ No newline at end of file
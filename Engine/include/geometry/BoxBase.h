@@ -87,7 +87,7 @@ public:
 	NUM_PLANES
   };
 
-  enum PlaneMasks : T {
+  enum PlaneMasks : unsigned int {
 	PlaneMaskLeft = (1 << LeftPlane),
 	PlaneMaskRight = (1 << RightPlane),
 	PlaneMaskTop = (1 << TopPlane),
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace omega {
+namespace geometry {
+
+// Index range of one level of detail inside a mesh's index buffer
+struct LodRange {
+  unsigned int first;  // in indices
+  unsigned int count;
+};
+
+constexpr int MAX_LODS = 4;
+
+// Projected bounding sphere radius, in half viewport heights, below which LOD i + 1 is used
+constexpr float LOD_SCREEN_SIZE[MAX_LODS - 1] = {0.25f, 0.1f, 0.04f};
+
+// Switching needs the size to pass a threshold by this fraction, so a slot
+// sitting on a boundary does not pop back and forth
+constexpr float LOD_HYSTERESIS = 0.15f;
+
+// Pick the level for a projected size, starting from the level used last time
+inline auto selectLod(float screenSize, int current, int levels) -> int {
+  int lod = current < levels ? current : levels - 1;
+  while (lod + 1 < levels && screenSize < LOD_SCREEN_SIZE[lod] * (1.0f - LOD_HYSTERESIS))
+	lod++;
+  while (lod > 0 && screenSize > LOD_SCREEN_SIZE[lod - 1] * (1.0f + LOD_HYSTERESIS))
+	lod--;
+  return lod;
+}
+
+}  // namespace geometry
+}  // namespace omega
@@ -21,6 +21,12 @@ T mDegrees(T radians)
 }
 
 
+template <class T>
+inline T mSquared(const T val)
+{
+    return val * val;
+}
+
 template <class T>
 inline double mSqrt(const T val)
 {
@@ -5,9 +5,14 @@
 #include <interface/Entity.h>
 #include <interface/Light.h>
 #include <system/PhysicsObject.h>
+#include <geometry/Box.h>
+#include <geometry/Sphere.h>
+#include <geometry/Vertex.h>
+#include <geometry/Lod.h>
 #include <memory>
 #include <vector>
 #include <optional>
+#include <cstdint>
 
 #include "glm/gtc/matrix_transform.hpp"
 #include <reactphysics3d/reactphysics3d.h>
@@ -17,11 +22,36 @@ namespace render {
 class Camera;
 class Shader;
 class Texture;
+struct OccluderMesh;
 }  // namespace render
 namespace geometry {
 
 enum class ObjectType { Elements, Array };
 
+struct SceneTables;
+
+// Everything needed to issue the draw call for one object
+struct OMEGA_EXPORT DrawParams {
+  unsigned int vao;
+  unsigned int count;
+  ObjectType type;
+  IndexType indices{IndexType::U32};
+  unsigned int first{0};  // first index or vertex, selects the level of detail
+
+  auto draw() const -> void;
+  auto drawInstanced(unsigned int instances) const -> void;
+};
+
+// GPU buffers of a mesh uploaded by ObjectGenerator::mesh, static batching copies from them
+struct MeshBuffers {
+  VertexFormat format{VertexFormat::Full};
+  std::array<unsigned int, MAX_VERTEX_STREAMS> streams{};
+  unsigned int ebo{0};
+  unsigned int vertices{0};
+  unsigned int indexCount{0};  // all levels of detail
+  IndexType indices{IndexType::U32};
+};
+
 class OMEGA_EXPORT Object : public interface::Entity {
 public:
   Object(unsigned int vao, unsigned int vbo, unsigned int cnt,
@@ -34,42 +64,101 @@ public:
 
   auto debug(bool) -> void;
 
-  void setName(std::string name) { name_ = name; }
-  void setMaterial(render::Material material) { material_ = material; }
-  void setModel(glm::mat4x4 mat) { model_ = mat; }
-  void setShader(std::shared_ptr<render::Shader> shader) { shader_ = shader; }
+  void setName(std::string name) {
+	name_ = name;
+	stateChanged();
+  }
+  void setMaterial(render::Material material) {
+	material_ = material;
+	stateChanged();
+  }
+  void setModel(glm::mat4x4 mat) {
+	model_ = mat;
+	updateWorld();
+  }
+  void setShader(std::shared_ptr<render::Shader> shader) {
+	shader_ = shader;
+	stateChanged();
+  }
   void addTexture(std::shared_ptr<render::Texture> texture) {
 	textures_.push_back(texture);
+	stateChanged();
   };
   void setTextures(std::vector<std::shared_ptr<render::Texture>> textures) {
 	textures_ = textures;
+	stateChanged();
   };
 
   void affectedByLights(std::vector<std::shared_ptr<interface::Light>> lights) {
 	lights_ = lights;
   }
 
-  glm::vec3 entityPosition() { return glm::vec3(model_[3]); }
+  glm::vec3 entityPosition() { return glm::vec3(world_[3]); }
+
+  // World transform of the owning node, model_ is applied on top of it
+  auto setParentTransform(const glm::mat4 &parent) -> void;
+  inline auto world() const -> const glm::mat4 & { return world_; }
+
+  // Scale of a shared unit mesh, applied under model_ and kept out of physics
+  auto setMeshScale(const glm::vec3 &scale) -> void;
+
+  // Bounding volumes in mesh space, the world copies follow world()
+  auto setBounds(const Box3<float>& box) -> void;
+  inline auto hasBounds() const -> bool { return has_bounds_; }
+  inline auto localBounds() const -> const Box3<float>& { return local_box_; }
+  inline auto worldBounds() const -> const Box3<float>& { return world_box_; }
+  inline auto worldSphere() const -> const Sphere<float>& { return world_sphere_; }
+
+  // Moved by the physics world every process(), not just when placed
+  inline auto isDynamic() const -> bool {
+	return body_!=nullptr && physicsObject_.bodyType!=physics::BodyType::STATIC;
+  }
 
   auto name() -> std::string { return name_; }
   auto scale(float) -> void;
   auto position(glm::vec3) -> void;
   auto physics(physics::PhysicsObject physicsObject) -> void { physicsObject_ = physicsObject; }
-  inline auto visible(bool val) -> void { visible_ = val; }
+  inline auto visible(bool val) -> void {
+	visible_ = val;
+	stateChanged();
+  }
   inline auto visible() -> bool { return visible_; }
   
+  auto setMeshBuffers(const MeshBuffers &buffers) -> void { mesh_buffers_ = buffers; }
+  inline auto meshBuffers() const -> const MeshBuffers & { return mesh_buffers_; }
+  inline auto drawParams() const -> DrawParams { return {vao_, count_, type_, mesh_buffers_.indices}; }
+
+  // Index ranges of the levels of detail past LOD 0, which is the whole count_
+  auto setLods(const std::vector<LodRange> &lods) -> void { lods_ = lods; }
+  inline auto lods() const -> const std::vector<LodRange> & { return lods_; }
+
+  // Geometry rasterized into the scene's occlusion buffer, hides what is behind it
+  auto setOccluder(std::shared_ptr<const render::OccluderMesh> occluder) -> void {
+	occluder_ = std::move(occluder);
+	stateChanged();
+  }
+  inline auto occluder() const -> const render::OccluderMesh * { return occluder_.get(); }
+
   // Getters for portal rendering
   unsigned int getVAO() const { return vao_; }
   unsigned int getCount() const { return count_; }
   ObjectType getType() const { return type_; }
-  glm::mat4 getModel() const { return model_; }
+  glm::mat4 getModel() const { return world_; }
 
 protected:
+  friend struct SceneTables;
+
+  auto updateWorld() -> void;
+  auto stateChanged() -> void;
+
   std::string name_;
   unsigned int vao_;
   unsigned int vbo_;
   unsigned int count_;
   ObjectType type_{ObjectType::Array};
+  MeshBuffers mesh_buffers_;
+  std::vector<LodRange> lods_;
+  std::shared_ptr<const render::OccluderMesh> occluder_;
 
   reactphysics3d::RigidBody *body_{nullptr};
   physics::PhysicsObject physicsObject_;
@@ -77,10 +166,25 @@ protected:
 
   bool visible_{true};
   glm::mat4 model_;
+  glm::mat4 parent_{1.0f};
+  glm::mat4 world_{1.0f};
+  bool has_parent_{false};
+  glm::vec3 mesh_scale_{1.0f};
+  bool has_mesh_scale_{false};
+
+  bool has_bounds_{false};
+  Box3<float> local_box_;
+  Sphere<float> local_sphere_;
+  Box3<float> world_box_;
+  Sphere<float> world_sphere_;
   std::optional<render::Material> material_;
   std::shared_ptr<render::Shader> shader_;
   std::vector<std::shared_ptr<render::Texture>> textures_;
   std::vector<std::shared_ptr<interface::Light>> lights_;
+
+  // Slot in the owning scene's tables, set while the scene is compiled
+  SceneTables *tables_{nullptr};
+  uint32_t slot_{0};
 };
 }  // namespace geometry
 }  // namespace omega
@@ -36,7 +36,19 @@ namespace geometry {
 struct ObjectNode {
   std::vector<std::shared_ptr<ObjectNode>> children;
   std::vector<std::shared_ptr<Object>> meshes;
-  glm::mat4x4 mat;
+  glm::mat4x4 mat{1.0f};    // local transform relative to the parent node
+  glm::mat4x4 world{1.0f};  // cached parent world * mat
+
+  ObjectNode *parent{nullptr};
+  bool dirty{true};       // mat changed since world was computed
+  bool childDirty{true};  // some descendant is dirty
+
+  // Replace the local transform and flag the path up to the root
+  auto setTransform(const glm::mat4x4 &local) -> void;
+
+  // Recompute world transforms below dirty nodes only, clean branches are
+  // skipped. Returns true when any world transform changed.
+  auto updateTransforms(const glm::mat4x4 &parentWorld, bool parentChanged) -> bool;
 };
 
 typedef std::shared_ptr<ObjectNode> ObjectNodePtr;
@@ -7,7 +7,9 @@
 #include <geometry/Object.h>
 #include <render/Camera.h>
 #include <render/PortalFramebuffer.h>
+#include <render/PortalFramebufferPool.h>
 #include <render/PortalCamera.h>
+#include <render/PortalViewCamera.h>
 #include <memory>
 #include <vector>
 #include <map>
@@ -24,11 +26,42 @@ namespace geometry {
  */
 class OMEGA_EXPORT PortalRenderer {
 public:
+  enum class Mode {
+    Texture,  // every portal view goes into the portal's framebuffer, drawn as a textured quad
+    Stencil,  // portal views go straight into the target, masked by stencil values per depth
+  };
+
+  /**
+   * When portal views seen by the player are rendered again (texture mode)
+   * A view is refreshed when the camera moved relative to its portal, either
+   * portal moved or its screen rectangle changed beyond a threshold, and at
+   * least every refreshInterval frames otherwise. In between the last image
+   * is reused, reprojected through the portal plane. At most viewBudget views
+   * (nested ones included) are rendered per frame, changed views go first,
+   * then the longest waiting. A portal with no image yet stays undrawn until
+   * the budget has room, and a refreshed view leaves out nested portals that
+   * would exceed it. Images of portals out of sight are kept for a while so
+   * returning portals have one.
+   */
+  struct UpdatePolicy {
+    float positionThreshold{0.01f};  // world units, camera relative to the portal
+    float angleThreshold{0.5f};      // degrees
+    float rectThreshold{0.01f};      // fraction of the screen
+    int refreshInterval{1};          // frames, 1 renders every view every frame
+    int viewBudget{0};               // portal views per frame, 0 for no limit
+  };
+
   PortalRenderer();
-  ~PortalRenderer() = default;
+  ~PortalRenderer();
+
+  PortalRenderer(const PortalRenderer&) = delete;
+  PortalRenderer& operator=(const PortalRenderer&) = delete;
 
   /**
    * Render portal views to framebuffers (call BEFORE main scene render)
+   * Portals seen through a portal are rendered first from the transformed
+   * camera, up to the max recursion depth. Framebuffers come from a pool per
+   * depth, only the outermost views are kept until renderPortalSurfaces.
    * @param scene The scene to render portals for
    * @param playerCamera The player's camera
    * @param portalShader Shader to use for rendering portal surfaces (unused here, kept for compatibility)
@@ -45,6 +78,24 @@ public:
   void renderPortalSurfaces(std::shared_ptr<render::Camera> playerCamera,
                             std::shared_ptr<render::Shader> portalShader = nullptr);
 
+  /**
+   * Render portal views through the stencil buffer (call AFTER main scene render)
+   * Each level marks its portal's pixels with the next stencil value, pushes
+   * their depth to the far plane, draws the destination view there with an
+   * oblique near plane, recurses and finally restores the portal's depth.
+   * The target needs a stencil buffer, no framebuffers are used.
+   * @param scene The scene to render portals for
+   * @param playerCamera The player's camera
+   */
+  void renderStencilPortals(std::shared_ptr<Scene> scene,
+                            std::shared_ptr<render::Camera> playerCamera);
+
+  /**
+   * Select how portal views reach the screen
+   */
+  void setMode(Mode mode) { mode_ = mode; }
+  Mode getMode() const { return mode_; }
+
   /**
    * Add a portal pair to be rendered
    */
@@ -60,6 +111,18 @@ public:
    */
   void setMaxRecursionDepth(int depth) { maxRecursionDepth_ = depth; }
 
+  /**
+   * Largest framebuffer a portal view is rendered to, smaller portals on
+   * screen get smaller pooled targets
+   */
+  void setFramebufferSize(int width, int height) { framebufferSize_ = glm::ivec2(width, height); }
+
+  /**
+   * Temporal reuse of portal views, see UpdatePolicy
+   */
+  void setUpdatePolicy(const UpdatePolicy& policy) { updatePolicy_ = policy; }
+  const UpdatePolicy& getUpdatePolicy() const { return updatePolicy_; }
+
   /**
    * Enable/disable portal rendering
    */
@@ -67,24 +130,146 @@ public:
   bool isEnabled() const { return enabled_; }
 
 private:
+  // Rendered view of one portal, rect stretched over size pixels of the framebuffer.
+  // viewProjection put the portal on screen when it was rendered.
+  struct PortalView {
+    render::PortalFramebuffer* framebuffer{nullptr};
+    glm::ivec2 size{0};
+    glm::vec4 rect{0.0f};
+    glm::mat4 viewProjection{1.0f};
+  };
+
+  // Portal seen by the player this frame, waiting for the update policy
+  struct ViewRequest {
+    std::shared_ptr<Portal> source;
+    std::shared_ptr<Portal> dest;
+    glm::vec4 rect{0.0f};
+    glm::mat4 pose{1.0f};           // camera in the source portal's space
+    glm::mat4 destTransform{1.0f};
+    bool changed{false};
+    uint64_t age{0};                // frames since the cached view was rendered
+    unsigned int query{0};          // last frame's occlusion query, 0 for none
+    bool confirmed{false};          // its result was known on the CPU
+  };
+
+  // Last rendered outermost view of a portal
+  struct CachedView {
+    PortalView view;
+    glm::mat4 pose{1.0f};
+    glm::mat4 destTransform{1.0f};
+    uint64_t frame{0};     // rendered
+    uint64_t lastSeen{0};  // queued as seen by the player
+  };
+
+  /**
+   * Render view through a portal, including the portals visible in it
+   * Only the pixels inside rect are rendered, into a pooled target sized to
+   * the portal's footprint on screen.
+   * @param rect Screen rectangle (x0, y0, x1, y1) of the portal in [0, 1]
+   * @param parentView Scene view key of the camera looking at the portal
+   * @param condition Occlusion query the drawing waits on, targets are
+   *        cleared either way
+   * @return View held until the pool reclaims or the parent view releases
+   *         it; no framebuffer when nothing was rendered
+   */
+  PortalView renderPortalView(std::shared_ptr<Portal> sourcePortal,
+                              std::shared_ptr<Portal> destPortal,
+                              std::shared_ptr<Scene> scene,
+                              std::shared_ptr<render::Camera> playerCamera,
+                              const glm::vec4& rect,
+                              int recursionDepth = 0,
+                              uint64_t parentView = Scene::MAIN_VIEW,
+                              unsigned int condition = 0);
+
+  /**
+   * Queue the view of a portal seen by the player, unless last frame's
+   * occlusion query found its surface hidden
+   */
+  void queueOutermostView(std::shared_ptr<Portal> sourcePortal,
+                          std::shared_ptr<Portal> destPortal,
+                          std::shared_ptr<render::Camera> playerCamera,
+                          std::vector<ViewRequest>& requests);
+
+  /**
+   * Render a queued view, or reuse its cached image as the update policy allows
+   */
+  void renderOutermostView(const ViewRequest& request,
+                           std::shared_ptr<Scene> scene,
+                           std::shared_ptr<render::Camera> playerCamera);
+
+  /**
+   * Room left in this frame's view budget with pending views not yet counted
+   */
+  bool withinBudget(int pending) const;
+
   /**
-   * Render view through a portal
+   * Moved or turned beyond the update policy's thresholds
    */
-  void renderPortalView(std::shared_ptr<Portal> sourcePortal,
-                       std::shared_ptr<Portal> destPortal,
-                       std::shared_ptr<Scene> scene,
-                       std::shared_ptr<render::Camera> playerCamera,
-                       int recursionDepth = 0);
+  bool transformChanged(const glm::mat4& current, const glm::mat4& last) const;
+
+  /**
+   * Render a portal surface inside an occlusion query read by the next frame
+   */
+  void renderQueriedSurface(std::shared_ptr<Portal> portal,
+                            std::shared_ptr<render::Camera> playerCamera,
+                            std::shared_ptr<render::Shader> portalShader);
 
   /**
    * Render portal surface with framebuffer texture
+   * The texture is sampled where the surface was on screen when the view
+   * was rendered, exact on the portal plane for a reused view.
    */
   void renderPortalSurface(std::shared_ptr<Portal> portal,
                            std::shared_ptr<render::Camera> playerCamera,
-                           std::shared_ptr<render::Shader> portalShader);
+                           std::shared_ptr<render::Shader> portalShader,
+                           const PortalView& view);
+
+  /**
+   * Camera looking out of the destination portal, its projection clipped at the portal plane
+   */
+  std::shared_ptr<render::PortalViewCamera> createPortalCamera(std::shared_ptr<render::Camera> camera,
+                                                               std::shared_ptr<Portal> sourcePortal,
+                                                               std::shared_ptr<Portal> destPortal);
+
+  /**
+   * Screen rectangle of the portal quad, clamped to bounds
+   * @return false when the quad is outside the camera's clip volume or bounds
+   */
+  bool portalScreenRect(std::shared_ptr<Portal> portal,
+                        std::shared_ptr<render::Camera> camera,
+                        const glm::vec4& bounds,
+                        glm::vec4& rect) const;
+
+  /**
+   * Pixels (x, y, width, height) covered by a screen rectangle of a viewport
+   */
+  static glm::ivec4 pixelRect(const glm::vec4& rect, const glm::ivec4& target);
+
+  /**
+   * Render the view through one portal at one stencil level, then the portals inside it
+   */
+  void renderStencilView(std::shared_ptr<Portal> sourcePortal,
+                         std::shared_ptr<Portal> destPortal,
+                         std::shared_ptr<Scene> scene,
+                         std::shared_ptr<render::Camera> camera,
+                         const glm::vec4& rect,
+                         const glm::ivec4& target,
+                         int level,
+                         uint64_t parentView = Scene::MAIN_VIEW);
 
   /**
-   * Check if portal is visible from camera
+   * Draw the portal quad with the depth only mask program
+   */
+  void drawPortalMask(std::shared_ptr<Portal> portal, const glm::mat4& viewProjection);
+
+  /**
+   * Cached quad of a portal, created on first use
+   */
+  std::shared_ptr<Object> portalSurface(std::shared_ptr<Portal> portal,
+                                        std::shared_ptr<render::Shader> shader);
+
+  /**
+   * Check if portal is visible from camera: camera in front of it, quad inside the frustum
    */
   bool isPortalVisible(std::shared_ptr<Portal> portal,
                       std::shared_ptr<render::Camera> camera) const;
@@ -92,6 +277,30 @@ private:
   std::vector<std::shared_ptr<PortalPair>> portalPairs_;
   int maxRecursionDepth_{2};
   bool enabled_{true};
+  Mode mode_{Mode::Texture};
+
+  // Targets of all portal views, sized to their footprint on screen
+  render::PortalFramebufferPool framebufferPool_;
+  glm::ivec2 framebufferSize_{1024, 1024};
+  glm::ivec4 screenViewport_{0};
+
+  // GL_ANY_SAMPLES_PASSED query per portal seen by the player
+  struct PortalQuery {
+    unsigned int id{0};
+    bool issued{false};
+  };
+  std::map<std::shared_ptr<Portal>, PortalQuery> queries_;
+
+  // Outermost view of each portal this frame, drawn by renderPortalSurfaces
+  std::map<std::shared_ptr<Portal>, PortalView> portalViews_;
+
+  UpdatePolicy updatePolicy_;
+  std::map<std::shared_ptr<Portal>, CachedView> cachedViews_;
+  uint64_t frame_{0};
+  int viewsRendered_{0};
+
+  // Writes nothing but depth, positions come from an explicit view-projection
+  std::shared_ptr<render::Shader> maskShader_;
   
   // Cache portal surface objects to avoid recreating each frame
   std::map<std::shared_ptr<Portal>, std::shared_ptr<Object>> portalSurfaces_;
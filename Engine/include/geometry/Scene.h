@@ -13,11 +13,21 @@
 #include <render/PointLight.h>
 #include <render/DirectionalLight.h>
 #include <render/SpotLight.h>
+#include <render/FrameData.h>
+#include <render/LightClusters.h>
+#include <render/InstanceBuffer.h>
+#include <render/RenderQueue.h>
+#include <render/OcclusionBuffer.h>
+#include <render/GBuffer.h>
 
 #include <geometry/ObjectTree.h>
 #include <geometry/Object.h>
+#include <geometry/BVH.h>
+#include <geometry/SceneTables.h>
+#include <geometry/StaticBatch.h>
 #include <geometry/Vertex.h>
 #include <utils/ObjectGenerator.h>
+#include <system/WorkerPool.h>
 
 #include <reactphysics3d/reactphysics3d.h>
 
@@ -26,6 +36,7 @@
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 using namespace omega::render;
@@ -43,10 +54,16 @@ public:
   explicit Scene(bool gamma = false);
   explicit Scene(std::string const &path, bool gamma = false);
 
-  auto import(std::string const &path) -> void;
+  // flags are ObjectGenerator mesh flags, e.g. ogCompactVertices
+  auto import(std::string const &path, unsigned int flags = 0) -> void;
+
+  // Key of the main camera's view, portal views derive theirs from it
+  static constexpr uint64_t MAIN_VIEW = 0;
 
   void render();
-  void render(std::shared_ptr<render::Camera> camera);
+  // view identifies what is being looked through across frames, per-view
+  // state such as LOD hysteresis and Hi-Z pyramids is kept under it
+  void render(std::shared_ptr<render::Camera> camera, uint64_t view = MAIN_VIEW);
   void shaders(std::shared_ptr<render::Shader> shader,
 			   std::shared_ptr<render::Shader> lightShader);
   void lights(std::vector<std::shared_ptr<Light>>);
@@ -56,9 +73,42 @@ public:
   auto prepare() -> void;
   auto debug(bool val) -> void;
 
+  // Merge static meshes into shared buffers drawn with one call per program and texture set
+  auto staticBatching(bool enabled) -> void {
+	staticBatching_ = enabled;
+	tablesDirty_ = true;
+  }
+
+  // Cull and draw the static batch in compute shaders when the driver allows, implies static batching
+  auto gpuCulling(bool enabled) -> void {
+	gpuCulling_ = enabled;
+	tablesDirty_ = true;
+  }
+
+  // Shade opaque slots once per pixel from a G-buffer, the rest stays forward
+  auto deferredShading(bool enabled) -> void { deferred_ = enabled; }
+
+  // Lay down depth with a trivial program first, opaque lighting then only runs for visible pixels
+  auto depthPrepass(bool enabled) -> void { depthPrepass_ = enabled; }
+
+  // Ambient term of the clustered lighting programs, forward and deferred alike
+  auto ambient(const glm::vec4 &ambient) -> void { ambient_ = ambient; }
+  auto ambient() const -> const glm::vec4 & { return ambient_; }
+
+  // Test frustum visible slots against the occluders rasterized on the CPU
+  auto occlusionCulling(bool enabled) -> void { occlusionCulling_ = enabled; }
+
+  // Spatial queries against the object hierarchies
+  auto pick(const Point3<float> &start, const Point3<float> &end, float *t = nullptr) -> std::shared_ptr<Object>;
+  auto query(const Sphere<float> &sphere) -> std::vector<std::shared_ptr<Object>>;
+  auto query(const Box3<float> &box) -> std::vector<std::shared_ptr<Object>>;
+
   auto add(std::shared_ptr<ObjectNode> tree) ->void;
   auto add(std::shared_ptr<Object> object) ->void;
-  auto add(std::shared_ptr<Light> light) -> void { lights_.push_back(light); }
+  auto add(std::shared_ptr<Light> light) -> void {
+	lights_.push_back(light);
+	lightsDirty_ = true;
+  }
   auto add(std::shared_ptr<Camera> camera) -> unsigned int {
 	cameras_.push_back(camera);
 	return cameras_.size() - 1;
@@ -71,13 +121,20 @@ public:
   void setPortalRenderer(std::shared_ptr<PortalRenderer> renderer) { portalRenderer_ = renderer; }
   std::shared_ptr<PortalRenderer> getPortalRenderer() const { return portalRenderer_; }
 private:
-  void loadModel(std::string const &path);
-  auto prepare(ObjectNodePtr node) -> void;
-  auto render(ObjectNodePtr node, std::shared_ptr<render::Camera> camera) -> void;
-  auto process(ObjectNodePtr node) -> void;
-  auto object(std::string name, ObjectNodePtr node) -> std::shared_ptr<Object>;
-  void shaders(std::shared_ptr<render::Shader> shader, ObjectNodePtr node);
-  void lights(std::vector<std::shared_ptr<Light>> lights, ObjectNodePtr node);
+  void loadModel(std::string const &path, unsigned int flags = 0);
+  auto compile() -> void;
+  auto updateTransforms() -> void;
+  auto drawsItself(uint32_t slot) const -> bool;
+  auto instanceable(uint32_t slot) const -> bool;
+  auto sameDraw(uint32_t a, uint32_t b) const -> bool;
+  auto selectLods(const std::shared_ptr<render::Camera> &camera) -> void;
+  auto cullOccluded(const std::shared_ptr<render::Camera> &camera) -> void;
+  auto enqueue(const std::shared_ptr<render::Camera> &camera) -> void;
+  auto batch() -> void;
+  auto prepass(std::shared_ptr<render::Camera> &camera) -> void;
+  auto submit(std::shared_ptr<render::Camera> &camera, uint32_t first, uint32_t last,
+			  Shader *program = nullptr) -> void;
+  auto shadeDeferred(std::shared_ptr<render::Camera> &camera, const glm::ivec4 &viewport) -> void;
 
 protected:
   ObjectNodePtr _root;
@@ -97,6 +154,72 @@ protected:
 
   bool gammaCorrection{false};
   bool debug_{false};
+
+  // Per-view camera block shared by all programs, created on first render
+  std::unique_ptr<render::FrameData> frameData_;
+  float time_{0.0f};
+  glm::vec4 ambient_{0.0f};
+
+  // Clustered light buffers, repacked when lights may have moved
+  std::unique_ptr<render::LightClusters> lightClusters_;
+  bool lightsDirty_{true};
+
+  // The object tree flattened into slot tables, recompiled when it changes
+  SceneTables tables_;
+  bool tablesDirty_{true};
+
+  // Static slots are built once, physics driven ones are refitted after
+  // every process(). Slots without bounds are always drawn.
+  BVH staticHierarchy_;
+  BVH dynamicHierarchy_;
+  std::vector<uint32_t> unbounded_;
+  std::vector<uint32_t> visible_;
+
+  // Opt-in, visible slots flagged as occluders hide the rest of visible_
+  bool occlusionCulling_{false};
+  std::unique_ptr<system::WorkerPool> workers_;
+  std::unique_ptr<render::OcclusionBuffer> occlusion_;
+
+  // State kept per view key across frames: the level of detail per slot, so
+  // hysteresis compares against what that view drew last frame, and the
+  // view's G-buffer. Views not drawn for VIEW_IDLE_FRAMES frames are dropped.
+  struct ViewState {
+	std::vector<uint8_t> lods;
+	std::unique_ptr<render::GBuffer> gbuffer;
+	unsigned int lastFrame{0};
+  };
+  static constexpr unsigned int VIEW_IDLE_FRAMES = 120;
+  std::unordered_map<uint64_t, ViewState> views_;
+  std::vector<uint8_t> *lods_{nullptr};
+  unsigned int frame_{0};
+
+  // Visible slots sorted by pass, then state. Adjacent slots sharing program,
+  // mesh and textures are merged into one instanced call, the rest draw one by
+  // one. Blended slots always draw alone, in their back to front order.
+  struct DrawBatch {
+	uint32_t slot;  // first slot of the run, supplies mesh, program and textures
+	unsigned int first;
+	unsigned int count;
+	bool instanced;
+	uint32_t pass;
+  };
+  render::RenderQueue queue_;
+
+  // Opt-in, static slots covered by the batch skip the queue
+  std::unique_ptr<StaticBatch> staticBatch_;
+  bool staticBatching_{false};
+  bool gpuCulling_{false};
+  uint64_t view_{MAIN_VIEW};  // key of the current render's view
+  std::unique_ptr<render::InstanceBuffer> instances_;
+  std::vector<DrawBatch> batches_;
+
+  // Opt-in depth-only pass over the instanced opaque batches, which then test GL_EQUAL
+  bool depthPrepass_{false};
+  std::shared_ptr<Shader> depthShader_;
+
+  // Opt-in deferred path, one G-buffer per view so portal views keep their size
+  bool deferred_{false};
+  std::shared_ptr<Shader> gbufferShader_;
   
   // Portal rendering
   std::shared_ptr<PortalRenderer> portalRenderer_{nullptr};
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <system/Global.h>
+#include <geometry/Object.h>
+#include <geometry/ObjectTree.h>
+#include <render/Material.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace omega {
+namespace render {
+class Shader;
+class Texture;
+}  // namespace render
+namespace geometry {
+
+/**
+ * SceneTables - The scene's objects flattened into structure-of-arrays tables
+ * compile() walks the ObjectNode tree once and gives every object a slot, the
+ * same index in every table. Culling, drawing and physics sync run over the
+ * dense hot tables; names, textures and the owning Object are kept apart. Objects
+ * stay attached to their slot and push transform or state changes back in.
+ */
+struct OMEGA_EXPORT SceneTables {
+  static constexpr uint32_t NO_MATERIAL = ~0u;
+
+  enum Flags : uint8_t {
+	VISIBLE = 1 << 0,
+	BOUNDED = 1 << 1,
+	DYNAMIC = 1 << 2,
+	CUSTOM_RENDER = 1 << 3,  // subclass, may override Object::render and process
+	OCCLUDER = 1 << 4,
+	TRANSLUCENT = 1 << 5,  // material opacity below one
+	SKY = 1 << 6,
+	COMPACT = 1 << 7,  // compact vertex format, normals are octahedral packed
+  };
+
+  SceneTables() = default;
+  ~SceneTables();
+
+  SceneTables(const SceneTables &) = delete;
+  SceneTables &operator=(const SceneTables &) = delete;
+
+  auto compile(const ObjectNodePtr &root) -> void;
+  auto clear() -> void;
+  inline auto size() const -> uint32_t { return static_cast<uint32_t>(objects.size()); }
+
+  // Copy the object's current model matrix and bounds into its slot
+  auto syncTransform(uint32_t slot) -> void;
+  // Copy name, visibility, shader, material and textures into its slot
+  auto syncState(uint32_t slot) -> void;
+  // Pull dynamic body transforms from the physics world
+  auto syncBodies() -> void;
+  // Run the process() of subclassed objects, plain objects have nothing to do
+  auto processCustom() -> void;
+
+  // Material shininess of the slot, the default material's without one
+  auto shininess(uint32_t slot) const -> float;
+
+  // Levels of detail of the slot's mesh, at least one
+  inline auto lodCount(uint32_t slot) const -> int { return lodCounts[slot]; }
+  // Index range of one level, LOD 0 is the slot's draw params
+  auto lodRange(uint32_t slot, int lod) const -> LodRange;
+  // The slot's draw params narrowed to one level
+  auto lodDraw(uint32_t slot, int lod) const -> DrawParams;
+
+  // Hot tables
+  std::vector<glm::mat4> world;
+  std::vector<Box3<float>> bounds;
+  std::vector<Sphere<float>> spheres;
+  std::vector<DrawParams> draws;
+  std::vector<uint32_t> materials;
+  std::vector<uint32_t> textureSets;
+  std::vector<render::Shader *> shaders;
+  std::vector<reactphysics3d::RigidBody *> bodies;
+  std::vector<uint8_t> flags;
+  std::vector<uint32_t> dynamicSlots;
+  std::vector<uint32_t> customSlots;
+  std::vector<uint8_t> lodCounts;
+  std::vector<uint32_t> lodFirst;   // index of the slot's LOD 1 in lodRanges
+  std::vector<LodRange> lodRanges;
+
+  // Set when a static slot moved, the owner refits its static hierarchy
+  bool staticMoved{false};
+
+  // Cold tables
+  std::vector<std::string> names;
+  std::vector<std::vector<render::Texture *>> textureSetTable;
+  std::vector<std::shared_ptr<Object>> objects;
+  std::vector<render::Material> materialTable;
+
+private:
+  // Material fields that tell materials apart: shininess, opacity, specular map
+  using MaterialKey = std::tuple<float, float, render::Texture *>;
+  struct MaterialKeyHash {
+	auto operator()(const MaterialKey &key) const -> size_t;
+  };
+  struct TextureSetHash {
+	auto operator()(const std::vector<render::Texture *> &textures) const -> size_t;
+  };
+
+  auto append(const ObjectNodePtr &node) -> void;
+  auto materialId(const render::Material &material) -> uint32_t;
+  auto textureSetId(const std::vector<render::Texture *> &textures) -> uint32_t;
+
+  // Ids of the deduplicated cold table entries
+  std::unordered_map<MaterialKey, uint32_t, MaterialKeyHash> materialIds_;
+  std::unordered_map<std::vector<render::Texture *>, uint32_t, TextureSetHash> textureSetIds_;
+};
+
+}  // namespace geometry
+}  // namespace omega
@@ -12,9 +12,9 @@ public:
   T radius;
 
 public:
-  Sphere<T>() {}
+  Sphere() {}
 
-  Sphere<T>(const Point3 <T> &in_rPosition, const T in_rRadius)
+  Sphere(const Point3 <T> &in_rPosition, const T in_rRadius)
 	  : center(in_rPosition),
 		radius(in_rRadius) {
 	if (radius < 0.0f)
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <system/Global.h>
+#include <render/InstanceBuffer.h>
+#include <render/GpuCulling.h>
+#include <geometry/Vertex.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace omega {
+namespace render {
+class Camera;
+class Shader;
+}  // namespace render
+namespace geometry {
+
+struct SceneTables;
+
+/**
+ * StaticBatch - Static meshes merged into shared vertex and index buffers
+ * Every static slot with an indexed mesh of its own is copied into the pool
+ * for its vertex format and index type. Each copied vertex carries the index
+ * of its draw record
+ * (transform, shininess) in a texture buffer, so a view draws all visible
+ * batched slots of one program and texture set with a single
+ * glMultiDrawElementsBaseVertex call. Meshes are copied with all their
+ * levels of detail, each slot draws the range of the level chosen for it.
+ *
+ * GPU driven, the records are culled by GpuCulling instead and every group
+ * is drawn from the indirect commands it wrote. The draw id then comes in as
+ * an instanced attribute offset by each command's baseInstance.
+ */
+class OMEGA_EXPORT StaticBatch {
+public:
+  static constexpr uint32_t NONE = ~0u;
+  static constexpr unsigned int DRAW_ID_LOCATION = 5;
+
+  StaticBatch() = default;
+  ~StaticBatch();
+
+  StaticBatch(const StaticBatch &) = delete;
+  StaticBatch &operator=(const StaticBatch &) = delete;
+
+  // Cull and draw through GpuCulling when the driver supports it, takes effect on the next build
+  auto gpuCulling(bool enabled) -> void;
+  inline auto gpuDriven() const -> bool { return culling_!=nullptr; }
+
+  // Collect the batchable slots and copy their meshes, drops the previous batch
+  auto build(const SceneTables &tables, const std::vector<uint32_t> &slots) -> void;
+  auto clear() -> void;
+
+  // Rewrite the draw records after static slots moved
+  auto refresh(const SceneTables &tables) -> void;
+
+  // The slot is batched, still opaque and still has the program and textures it was built with
+  auto covers(const SceneTables &tables, uint32_t slot) const -> bool;
+  inline auto empty() const -> bool { return draws_.empty(); }
+
+  // Gather the batched slots among the visible ones, lods holds the level per slot.
+  // GPU driven both are ignored, the records are culled for the view instead.
+  auto prepare(const SceneTables &tables, const std::vector<uint32_t> &visible, const std::vector<uint8_t> &lods,
+			   const std::shared_ptr<render::Camera> &camera, uint64_t view) -> void;
+
+  // Draw what prepare() kept, program replaces the groups' own, depth only draws bind no textures
+  auto draw(const SceneTables &tables, const std::shared_ptr<render::Camera> &camera,
+			render::Shader *program = nullptr, bool textures = true) -> void;
+
+  // Keep the view's depth for next frame's occlusion test, GPU driven only
+  auto captureDepth(render::Camera &camera, uint64_t view, const glm::ivec4 &viewport) -> void;
+  // The view is gone, free what was kept for it
+  auto forgetView(uint64_t view) -> void;
+
+private:
+  auto upload(const SceneTables &tables, unsigned int pool) -> void;
+  auto uploadRecords(const SceneTables &tables) -> void;
+  auto refreshEnabled(const SceneTables &tables) -> void;
+
+  // Shared buffers for all meshes of one vertex format and index type
+  struct Pool {
+	VertexFormat format;
+	IndexType indices;
+	size_t vertexCount{0};
+	size_t indexCount{0};
+	std::array<unsigned int, MAX_VERTEX_STREAMS> streams{};
+	unsigned int ebo{0};
+	unsigned int drawIds{0};
+	unsigned int vao{0};
+	unsigned int indirectVao{0};  // draw id per instance from ids_
+  };
+
+  // One batched slot inside its pool
+  struct Draw {
+	uint32_t slot;
+	unsigned int group;
+	unsigned int count;  // indices of all levels
+	size_t indexOffset;  // bytes into the pool's index buffer
+	int baseVertex;
+  };
+
+  // Slots sharing pool, program and textures, drawn with one call
+  struct Group {
+	unsigned int pool;
+	render::Shader *shader;
+	uint32_t textureSet;
+	std::vector<int> counts;
+	std::vector<const void *> offsets;
+	std::vector<int> baseVertices;
+  };
+
+  std::vector<uint32_t> records_;  // per slot, index into draws_ or NONE
+  std::vector<Draw> draws_;
+  std::vector<Group> groups_;
+  std::vector<Pool> pools_;
+  render::InstanceBuffer data_;
+
+  std::unique_ptr<render::GpuCulling> culling_;
+  unsigned int ids_{0};                 // 0, 1, 2, ... one per record
+  std::vector<uint8_t> enabled_;        // per record, as last uploaded
+};
+
+}  // namespace geometry
+}  // namespace omega
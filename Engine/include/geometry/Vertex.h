@@ -6,6 +6,8 @@
 #include <geometry/Matrix.h>
 #include <geometry/Sphere.h>
 #include <geometry/BoxBase.h>
+#include <array>
+#include <cstdint>
 
 namespace omega {
 namespace geometry {
@@ -17,5 +19,27 @@ struct Vertex {
   glm::vec3 bitangent;
 };
 
+// Layouts a mesh can be uploaded in, see geometry/VertexLayout.h
+enum class VertexFormat : uint8_t {
+  Full,            // one interleaved stream of Vertex
+  Compact,         // positions, packed normal and uv
+  CompactTangent,  // Compact plus a packed tangent stream
+};
+
+enum class IndexType : uint8_t { U16, U32 };
+
+constexpr int MAX_VERTEX_STREAMS = 3;
+
+// Octahedral snorm16 normal and half float uv
+struct PackedSurface {
+  int16_t normal[2];
+  uint16_t uv[2];
+};
+
+// Octahedral snorm16 tangent, the bitangent sign in w
+struct PackedTangent {
+  int16_t tangent[4];
+};
+
 }  // namespace geometry
 }  // namespace omega
\ No newline at end of file
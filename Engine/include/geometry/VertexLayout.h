@@ -0,0 +1,84 @@
+#pragma once
+
+#include <system/Global.h>
+#include <geometry/Vertex.h>
+#include <glad/glad.h>
+#include <cstddef>
+
+namespace omega {
+namespace geometry {
+
+/**
+ * VertexLayout - Compile-time vertex attribute descriptors
+ * A layout is a list of streams, each stream one buffer of interleaved
+ * elements, each attribute a location, component count and GL type at a
+ * fixed offset in the element. setup() expands into the matching
+ * glVertexAttribPointer calls for the bound vertex array.
+ */
+template <unsigned int Location, int Components, unsigned int Type, bool Normalized, size_t Offset>
+struct VertexAttribute {
+  static void setup(int stride) {
+	glEnableVertexAttribArray(Location);
+	glVertexAttribPointer(Location, Components, Type, Normalized ? GL_TRUE : GL_FALSE, stride,
+						  reinterpret_cast<const void *>(Offset));
+  }
+};
+
+template <class Element, class... Attributes>
+struct VertexStream {
+  static constexpr int STRIDE = sizeof(Element);
+
+  static void setup(unsigned int buffer) {
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	(Attributes::setup(STRIDE), ...);
+  }
+};
+
+template <class... Streams>
+struct VertexLayout {
+  static constexpr int STREAMS = sizeof...(Streams);
+  static constexpr int VERTEX_SIZE = (Streams::STRIDE + ...);
+  static constexpr std::array<int, STREAMS> STRIDES{Streams::STRIDE...};
+  static_assert(STREAMS <= MAX_VERTEX_STREAMS, "too many vertex streams");
+
+  // One buffer per stream, in declaration order
+  static void setup(const unsigned int *buffers) {
+	int stream = 0;
+	(Streams::setup(buffers[stream++]), ...);
+  }
+};
+
+// Packed normals and tangents use their own locations, core.vs decodes them
+constexpr unsigned int NORMAL_OCT_LOCATION = 6;
+constexpr unsigned int TANGENT_OCT_LOCATION = 7;
+
+using FullLayout = VertexLayout<
+	VertexStream<Vertex,
+				 VertexAttribute<0, 3, GL_FLOAT, false, offsetof(Vertex, position)>,
+				 VertexAttribute<1, 3, GL_FLOAT, false, offsetof(Vertex, normal)>,
+				 VertexAttribute<2, 2, GL_FLOAT, false, offsetof(Vertex, uv)>,
+				 VertexAttribute<3, 3, GL_FLOAT, false, offsetof(Vertex, tangent)>,
+				 VertexAttribute<4, 3, GL_FLOAT, false, offsetof(Vertex, bitangent)>>>;
+
+using PositionStream = VertexStream<glm::vec3, VertexAttribute<0, 3, GL_FLOAT, false, 0>>;
+using SurfaceStream = VertexStream<PackedSurface,
+								   VertexAttribute<NORMAL_OCT_LOCATION, 2, GL_SHORT, true, offsetof(PackedSurface, normal)>,
+								   VertexAttribute<2, 2, GL_HALF_FLOAT, false, offsetof(PackedSurface, uv)>>;
+using TangentStream = VertexStream<PackedTangent, VertexAttribute<TANGENT_OCT_LOCATION, 4, GL_SHORT, true, 0>>;
+
+using CompactLayout = VertexLayout<PositionStream, SurfaceStream>;
+using CompactTangentLayout = VertexLayout<PositionStream, SurfaceStream, TangentStream>;
+
+// Runtime dispatch over the layouts above
+OMEGA_EXPORT auto streamCount(VertexFormat format) -> int;
+OMEGA_EXPORT auto streamStride(VertexFormat format, int stream) -> int;
+OMEGA_EXPORT auto setupVertexFormat(VertexFormat format, const unsigned int *buffers) -> void;
+OMEGA_EXPORT auto indexSize(IndexType type) -> int;
+OMEGA_EXPORT auto indexGLType(IndexType type) -> unsigned int;
+
+// Pack one vertex into the compact streams
+OMEGA_EXPORT auto packSurface(const Vertex &vertex) -> PackedSurface;
+OMEGA_EXPORT auto packTangent(const Vertex &vertex) -> PackedTangent;
+
+}  // namespace geometry
+}  // namespace omega
@@ -5,6 +5,8 @@
 #include <interface/Entity.h>
 #include <memory>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include "glm/gtc/matrix_transform.hpp"
 
@@ -17,6 +19,16 @@ namespace interface {
 
 enum class LightType { POINT, DIRECTIONAL, SPOT };
 
+// Light packed for the clustered light buffer, one RGBA32F texel per member
+struct GpuLight {
+  glm::vec4 position{0.0f};   // xyz = world position, w = LightType
+  glm::vec4 direction{0.0f};  // xyz = direction, w = range of influence
+  glm::vec4 ambient{0.0f};    // rgb, w = constant attenuation
+  glm::vec4 diffuse{0.0f};    // rgb, w = linear attenuation
+  glm::vec4 specular{0.0f};   // rgb, w = quadratic attenuation
+  glm::vec4 cone{0.0f};       // x = cutOff, y = outerCutOff
+};
+
 class OMEGA_EXPORT Light : public Entity {
  public:
   Light() = default;
@@ -26,6 +38,24 @@ class OMEGA_EXPORT Light : public Entity {
   virtual void dump() = 0;
   virtual LightType type() = 0;
   virtual void setup(std::shared_ptr<render::Shader>) = 0;
+
+  // Fill the clustered representation, lights that can't be packed return false
+  virtual auto pack(GpuLight&) -> bool { return false; }
+  // True when the light moved since it was last packed, e.g. a tracked entity
+  virtual auto changed() -> bool { return false; }
+
+  // Distance where the attenuated light drops below 5/256 of its peak intensity
+  static auto attenuationRange(float constant, float linear, float quadratic,
+                               float intensity) -> float {
+    float target = intensity * 256.0f / 5.0f;
+    if (quadratic > 0.0f) {
+      float disc = linear * linear - 4.0f * quadratic * (constant - target);
+      return (-linear + std::sqrt(std::max(disc, 0.0f))) / (2.0f * quadratic);
+    }
+    if (linear > 0.0f)
+      return std::max((target - constant) / linear, 0.0f);
+    return INFINITY;
+  }
 };
 }  // namespace interface
 }  // namespace omega
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <string>
 #include <memory>
+#include <array>
 
 #include <geometry/Point3.h>
 #include <geometry/Matrix.h>
@@ -41,7 +42,7 @@ public:
 
   auto updateShader() -> void;
 
-  glm::mat4 viewMatrix() const;
+  virtual glm::mat4 viewMatrix() const;
 
   virtual void processKeyboard(Camera_Movement direction, float deltaTime);
   void processMouseMovement(float xoffset, float yoffset,
@@ -53,7 +54,20 @@ public:
   auto setLookAt(glm::vec3 lookAt) -> void;
   auto setPerspective(float const &fov, float const &width, float const &height,
 					  float const &near, float const &far) -> void;
-  auto projectionMatrix() -> glm::mat4x4 { return projection_matrix_; }
+  virtual auto projectionMatrix() -> glm::mat4x4 { return projection_matrix_; }
+  // Projection the frustum planes are taken from, may be narrower than the rendered one
+  virtual auto cullingProjection() -> glm::mat4x4 { return projectionMatrix(); }
+  // Projection onto the final screen, what sizes on screen such as LOD selection are measured with
+  virtual auto screenProjection() -> glm::mat4x4 { return projectionMatrix(); }
+  auto nearPlane() const -> float { return near_; }
+
+  // Frustum planes (left, right, bottom, top, near, far) of the current
+  // culling view-projection, normals point inwards. Rebuilt only when the matrices change.
+  auto frustum() -> const std::array<geometry::Plane<float>, 6> &;
+  auto isVisible(const geometry::Box3<float> &box) -> bool;
+  auto isVisible(const geometry::Sphere<float> &sphere) -> bool;
+
+  auto farPlane() const -> float { return far_; }
   glm::mat4x4 calculate_lookAt_matrix(glm::vec3 position, glm::vec3 target,
 									  glm::vec3 worldUp);
   void updateCameraVectors();
@@ -66,6 +80,11 @@ public:
 protected:
   // camera Attributes
   glm::mat4x4 projection_matrix_;
+  float near_{0.1f};
+  float far_{100.0f};
+
+  std::array<geometry::Plane<float>, 6> frustum_;
+  glm::mat4 frustum_view_proj_{0.0f};
 
   std::shared_ptr<Shader> shader_;
 
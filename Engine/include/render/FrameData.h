@@ -0,0 +1,49 @@
+#pragma once
+
+#include <system/Global.h>
+#include <glm/glm.hpp>
+
+namespace omega {
+namespace render {
+
+class Camera;
+
+/**
+ * FrameData - Per-view camera state shared by all shader programs
+ * Uploaded once per rendered view into a std140 uniform block that every
+ * program declaring "FrameData" reads from the fixed binding point BINDING.
+ */
+class OMEGA_EXPORT FrameData {
+public:
+  static constexpr unsigned int BINDING = 0;
+  static constexpr const char* BLOCK_NAME = "FrameData";
+
+  // Mirrors the std140 layout of the GLSL block (viewPos and time share a vec4 slot)
+  struct Block {
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    glm::mat4 viewProj{1.0f};
+    glm::vec3 viewPos{0.0f};
+    float time{0.0f};
+    glm::vec4 ambient{0.0f};
+  };
+
+  FrameData();
+  ~FrameData();
+
+  FrameData(const FrameData&) = delete;
+  FrameData& operator=(const FrameData&) = delete;
+
+  // Upload the camera matrices and scene terms and bind the buffer to BINDING
+  void update(Camera& camera, float time, const glm::vec4& ambient);
+
+  const Block& block() const { return block_; }
+  unsigned int getUBO() const { return ubo_; }
+
+private:
+  unsigned int ubo_{0};
+  Block block_;
+};
+
+}  // namespace render
+}  // namespace omega
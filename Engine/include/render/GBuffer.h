@@ -0,0 +1,58 @@
+#pragma once
+
+#include <system/Global.h>
+#include <glm/glm.hpp>
+#include <memory>
+
+namespace omega {
+namespace render {
+
+class Camera;
+class Shader;
+
+/**
+ * GBuffer - Geometry buffer of the deferred path and the pass lighting it
+ * The opaque pass writes albedo with specular intensity, an octahedral
+ * normal with shininess and depth. resolve() then shades every covered pixel
+ * once in a full screen pass, walking the same light clusters as core.fs, and
+ * writes the depth into the target so forward passes can follow.
+ */
+class OMEGA_EXPORT GBuffer {
+public:
+  // Units the attachments are bound to while resolving
+  static constexpr int ALBEDO_UNIT = 0;
+  static constexpr int SURFACE_UNIT = 1;
+  static constexpr int DEPTH_UNIT = 2;
+
+  GBuffer();
+  ~GBuffer();
+
+  GBuffer(const GBuffer&) = delete;
+  GBuffer& operator=(const GBuffer&) = delete;
+
+  // Remember the bound framebuffer, then bind and clear the attachments sized to viewport
+  void begin(const glm::ivec4& viewport);
+
+  // Light the attachments into the remembered framebuffer, the ambient term comes from FrameData
+  void resolve(Camera& camera);
+
+private:
+  void allocate(const glm::ivec2& size);
+  void destroy();
+  auto attach(unsigned int attachment, int internalFormat, unsigned int format, unsigned int type) -> unsigned int;
+
+  std::shared_ptr<Shader> lighting_;
+  unsigned int vao_{0};  // empty, the full screen triangle comes from gl_VertexID
+
+  unsigned int fbo_{0};
+  unsigned int albedo_{0};   // RGBA8, rgb = diffuse, a = specular
+  unsigned int surface_{0};  // RGBA16F, xy = octahedral normal, z = shininess
+  unsigned int depth_{0};
+  glm::ivec2 size_{0};
+
+  int target_{0};
+  glm::ivec4 viewport_{0};
+};
+
+}  // namespace render
+}  // namespace omega
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <system/Global.h>
+#include <array>
+
+namespace omega {
+namespace render {
+
+/**
+ * GLState - Cache of the most frequently rebound GL state
+ * Program, vertex array and per-unit texture bindings made through here are
+ * skipped when they would not change anything. Code that binds these directly
+ * must call invalidate() before the cache is relied on again; the scene does so
+ * at the start of every render queue submission.
+ */
+class OMEGA_EXPORT GLState {
+public:
+  static constexpr int MAX_TEXTURE_UNITS = 16;
+  // Unit textures are bound on while they are created and filled
+  static constexpr int UPLOAD_UNIT = 0;
+
+  static void useProgram(unsigned int program);
+  static void bindVertexArray(unsigned int vao);
+  static void bindTexture(int unit, unsigned int target, unsigned int texture);
+  // Make unit current for calls acting on its bound texture, e.g. glTexImage2D
+  static void activeTexture(int unit);
+
+  // The program is being deleted, forget it if it is the cached one
+  static void forgetProgram(unsigned int program);
+  // The texture is being deleted, GL unbinds it from every unit
+  static void forgetTexture(unsigned int texture);
+
+  // Forget everything, the next call of each kind goes to GL
+  static void invalidate();
+
+private:
+  static auto targetIndex(unsigned int target) -> int;
+
+  static constexpr unsigned int UNKNOWN = ~0u;
+  static constexpr int TARGETS = 3;  // 2D, cube map, buffer
+
+  static unsigned int program_;
+  static unsigned int vao_;
+  static int activeUnit_;
+  static std::array<std::array<unsigned int, TARGETS>, MAX_TEXTURE_UNITS> textures_;
+};
+
+}  // namespace render
+}  // namespace omega
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <system/Global.h>
+#include <geometry/Lod.h>
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace omega {
+namespace render {
+
+class Camera;
+class Shader;
+
+// One culled draw, mirrors the std430 Record struct of cull.cs
+struct GpuCullRecord {
+  glm::vec4 boxMin;    // world bounds, w = 1 while the draw is enabled
+  glm::vec4 boxMax;    // w = 1 when the bounds are known, unbounded draws are never culled
+  glm::uvec4 firsts;   // first index of each level of detail
+  glm::uvec4 counts;   // index count of each level, 0 past the last one
+  glm::ivec4 draw;     // x = base vertex, y = group, z = group's first command, w = command inside the group
+};
+
+/**
+ * GpuCulling - Frustum and Hi-Z culling in a compute shader
+ * Every record is tested against the view frustum and against a depth
+ * pyramid built from the same view's depth one frame earlier, its level of
+ * detail is picked by projected size and surviving draws are written as
+ * DrawElementsIndirectCommands with baseInstance set to the record. With
+ * ARB_indirect_parameters the commands of a group are compacted by an atomic
+ * counter and drawn with glMultiDrawElementsIndirectCountARB, otherwise
+ * culled commands keep their place with no instances.
+ *
+ * All of it comes from extensions on top of the 3.3 core context, supported()
+ * tells whether the driver has them (Mesa's llvmpipe does).
+ */
+class OMEGA_EXPORT GpuCulling {
+public:
+  static constexpr int HI_Z_UNIT = 11;
+  static constexpr unsigned int WORKGROUP_SIZE = 64;
+
+  static auto supported() -> bool;
+
+  GpuCulling();
+  ~GpuCulling();
+
+  GpuCulling(const GpuCulling &) = delete;
+  GpuCulling &operator=(const GpuCulling &) = delete;
+
+  // Both programs linked, false when the shaders are missing
+  inline auto valid() const -> bool { return valid_; }
+  inline auto compacting() const -> bool { return compact_; }
+
+  // Replace the records, groupSizes holds the number of records of every group
+  auto upload(const std::vector<GpuCullRecord> &records, const std::vector<unsigned int> &groupSizes) -> void;
+
+  // Write this view's commands, view is the stable key of its depth pyramid
+  auto cull(Camera &camera, uint64_t view) -> void;
+
+  // Issue the commands of one group, the pool's vertex array must be bound
+  auto draw(unsigned int group, unsigned int indexType) -> void;
+
+  // Reduce the depth of the bound framebuffer into the view's pyramid for the next frame
+  auto capture(Camera &camera, uint64_t view, const glm::ivec4 &viewport) -> void;
+  // Free the view's pyramid
+  auto forget(uint64_t view) -> void;
+
+private:
+  // Max depth pyramid of one view
+  struct Pyramid {
+	unsigned int depth{0};    // copy of the framebuffer depth
+	unsigned int texture{0};  // R32F mip chain, level 0 is half the viewport
+	glm::ivec2 size{0};       // of the viewport
+	int levels{0};
+	glm::mat4 viewProjection{1.0f};
+	bool ready{false};
+  };
+
+  auto bindStorage(Shader &program, const char *block, unsigned int binding) -> void;
+
+  bool valid_{false};
+  bool compact_{false};
+  std::shared_ptr<Shader> cullProgram_;
+  std::shared_ptr<Shader> reduceProgram_;
+
+  unsigned int records_{0};
+  unsigned int commands_{0};
+  unsigned int counts_{0};
+  unsigned int recordCount_{0};
+  std::vector<unsigned int> groupFirst_;
+  std::vector<unsigned int> groupSizes_;
+  std::vector<unsigned int> zeros_;
+
+  std::unordered_map<uint64_t, Pyramid> pyramids_;
+};
+
+}  // namespace render
+}  // namespace omega
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <system/Global.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace omega {
+namespace render {
+
+// Per-instance data, read by the vertex shader as INSTANCE_TEXELS RGBA32F texels
+struct GpuInstance {
+  glm::mat4 model{1.0f};
+  glm::vec4 params{0.0f};  // x = shininess
+};
+
+/**
+ * InstanceBuffer - Per-instance data for instanced draws
+ * Instances are appended for one view, uploaded in one go into a texture
+ * buffer and fetched in the vertex shader with (instanceBase + gl_InstanceID).
+ * A texture buffer leaves the per-object vertex arrays untouched, so any
+ * objects sharing a VAO can be drawn together.
+ */
+class OMEGA_EXPORT InstanceBuffer {
+public:
+  static constexpr int INSTANCE_DATA_UNIT = 12;
+  static constexpr int INSTANCE_TEXELS = 5;
+
+  InstanceBuffer();
+  ~InstanceBuffer();
+
+  InstanceBuffer(const InstanceBuffer&) = delete;
+  InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+  void clear() { instances_.clear(); }
+  auto push(const glm::mat4& model, float shininess) -> unsigned int;
+  auto size() const -> unsigned int { return static_cast<unsigned int>(instances_.size()); }
+
+  // Upload the appended instances and bind them to INSTANCE_DATA_UNIT
+  void upload();
+  // Bind the last upload again, for data that outlives a single view
+  void bind();
+
+private:
+  std::vector<GpuInstance> instances_;
+  unsigned int buffer_{0};
+  unsigned int texture_{0};
+};
+
+}  // namespace render
+}  // namespace omega
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <system/Global.h>
+#include <interface/Light.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace omega {
+namespace render {
+
+class Camera;
+
+/**
+ * LightClusters - Clustered forward lighting data
+ * All scene lights live in one texture buffer. For every view the point and
+ * spot lights are binned on the CPU into a GRID_X x GRID_Y x GRID_Z grid of
+ * view-space froxels (exponential depth slices), so a fragment only walks the
+ * lights overlapping its own cluster. Directional lights are stored first and
+ * apply to every fragment.
+ */
+class OMEGA_EXPORT LightClusters {
+public:
+  static constexpr unsigned int BINDING = 1;
+  static constexpr const char* BLOCK_NAME = "LightClusterData";
+
+  // Texture units reserved for the cluster buffers
+  static constexpr int LIGHT_DATA_UNIT = 13;
+  static constexpr int CLUSTER_GRID_UNIT = 14;
+  static constexpr int LIGHT_INDEX_UNIT = 15;
+
+  static constexpr int GRID_X = 16;
+  static constexpr int GRID_Y = 9;
+  static constexpr int GRID_Z = 24;
+  static constexpr int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+  // Bounds the per-fragment cost, extra lights in a crowded cluster are dropped
+  static constexpr unsigned int MAX_LIGHTS_PER_CLUSTER = 32;
+
+  LightClusters();
+  ~LightClusters();
+
+  LightClusters(const LightClusters&) = delete;
+  LightClusters& operator=(const LightClusters&) = delete;
+
+  // Pack all lights into the light buffer
+  void updateLights(const std::vector<std::shared_ptr<interface::Light>>& lights);
+
+  // Bin the packed lights for one view and bind the cluster buffers
+  void build(Camera& camera, const glm::ivec4& viewport);
+
+  unsigned int lightCount() const { return static_cast<unsigned int>(lights_.size()); }
+  unsigned int directionalCount() const { return directionalCount_; }
+
+private:
+  // Mirrors the std140 layout of the GLSL block
+  struct Block {
+    glm::uvec4 grid;      // xyz = cluster counts, w = directional light count
+    glm::vec4 slicing;    // x = depth scale, y = depth bias, z = near, w = far
+    glm::vec4 viewport;   // x, y, width, height
+  };
+
+  // Cluster bounds covered by one light
+  struct Range {
+    unsigned int light;
+    int x0, x1, y0, y1, z0, z1;
+  };
+
+  auto slice(float depth, float scale, float bias) const -> int;
+  void upload(unsigned int buffer, size_t size, const void* data);
+
+  std::vector<interface::GpuLight> lights_;
+  unsigned int directionalCount_{0};
+
+  std::vector<Range> ranges_;
+  std::vector<glm::uvec2> grid_;  // offset, count per cluster
+  std::vector<unsigned int> indices_;
+  bool overflowReported_{false};
+
+  unsigned int ubo_{0};
+  unsigned int lightBuffer_{0};
+  unsigned int lightTexture_{0};
+  unsigned int gridBuffer_{0};
+  unsigned int gridTexture_{0};
+  unsigned int indexBuffer_{0};
+  unsigned int indexTexture_{0};
+};
+
+}  // namespace render
+}  // namespace omega
@@ -10,6 +10,7 @@ class Texture;
 
 struct Material {
   float shininess{16.f};
+  float opacity{1.f};  // below one the object is drawn in the blended pass
   std::shared_ptr<Texture> specular;
 };
 };  // namespace render
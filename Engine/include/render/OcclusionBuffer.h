@@ -0,0 +1,79 @@
+#pragma once
+
+#include <system/Global.h>
+#include <geometry/Box.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace omega {
+namespace system {
+class WorkerPool;
+}  // namespace system
+namespace render {
+
+// Triangles an object contributes to the occlusion buffer, in mesh space
+struct OMEGA_EXPORT OccluderMesh {
+  std::vector<glm::vec3> positions;
+  std::vector<unsigned int> indices;
+
+  // The twelve triangles of a box, exact for box shaped walls
+  static auto box(const geometry::Box3<float> &box) -> std::shared_ptr<OccluderMesh>;
+};
+
+/**
+ * OcclusionBuffer - Low resolution CPU depth buffer for occlusion culling
+ * Each view the designated occluders are transformed, clipped against the
+ * near plane and rasterized into a WIDTH x HEIGHT depth buffer, keeping the
+ * nearest depth per pixel. The buffer is split into horizontal bands
+ * rasterized in parallel on a WorkerPool, with SSE filling four pixels at a
+ * time. Candidates are then tested by the screen rectangle and nearest depth
+ * of their world bounds. Nothing here touches GL.
+ */
+class OMEGA_EXPORT OcclusionBuffer {
+public:
+  static constexpr int WIDTH = 256;
+  static constexpr int HEIGHT = 128;
+  static constexpr int BANDS = 8;
+  static constexpr int BAND_HEIGHT = HEIGHT / BANDS;
+  static_assert(WIDTH % 4 == 0 && HEIGHT % BANDS == 0, "rows are filled four pixels at a time, bands split evenly");
+
+  // Without workers the bands are rasterized on the calling thread
+  explicit OcclusionBuffer(system::WorkerPool *workers = nullptr);
+
+  // Start a view, clears the depth and the queued occluders
+  auto begin(const glm::mat4 &viewProjection) -> void;
+
+  // Queue the occluder's triangles placed by model
+  auto addOccluder(const OccluderMesh &mesh, const glm::mat4 &model) -> void;
+
+  // Rasterize everything queued since begin()
+  auto rasterize() -> void;
+
+  // False only when the whole box lies behind the rasterized occluders
+  auto visible(const geometry::Box3<float> &box) const -> bool;
+
+  // Nearest depth per pixel in [0, 1], row 0 at the bottom of the view
+  inline auto depth() const -> const std::vector<float> & { return depth_; }
+  inline auto triangleCount() const -> size_t { return triangles_.size(); }
+
+private:
+  // Screen space triangle, edges and depth as planes over the pixel position
+  struct Triangle {
+	glm::vec3 edges[3];  // x * a + y * b + c >= 0 inside
+	glm::vec3 plane;     // depth = x * a + y * b + c
+	int x0, x1, y0, y1;  // covered pixel rectangle, inclusive
+  };
+
+  auto addTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c) -> void;
+  auto rasterizeBand(int band) -> void;
+
+  system::WorkerPool *workers_;
+  glm::mat4 viewProjection_{1.0f};
+  std::vector<glm::vec4> clip_;
+  std::vector<Triangle> triangles_;
+  std::vector<float> depth_;
+};
+
+}  // namespace render
+}  // namespace omega
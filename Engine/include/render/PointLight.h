@@ -31,6 +31,7 @@ class OMEGA_EXPORT PointLight : public interface::Light {
 
   interface::LightType type() { return interface::LightType::POINT; }
   void setup(std::shared_ptr<render::Shader>);
+  auto pack(interface::GpuLight&) -> bool override;
   void dump();
   void render(std::shared_ptr<render::Camera>, std::shared_ptr<render::Shader>);
 
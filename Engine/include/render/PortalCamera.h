@@ -33,6 +33,8 @@ public:
   /**
    * Calculate view matrix with clipping plane support
    * Prevents seeing through the back of the portal
+   * @param clippingPlane Receives the destination portal's plane in world space,
+   *        the virtual camera on its negative side
    */
   static glm::mat4 calculatePortalViewWithClipping(
       const Camera& playerCamera,
@@ -67,10 +69,24 @@ public:
   /**
    * Get clipping plane for portal (prevents seeing portal backside)
    * @param portal The portal to get clipping plane for
-   * @return Clipping plane equation (normal.x, normal.y, normal.z, distance)
+   * @return Plane equation dot(plane.xyz, p) + plane.w = 0, positive on the portal's front
    */
   static glm::vec4 getClippingPlane(const geometry::Portal& portal);
 
+  /**
+   * Replace the near plane of a projection with the portal's plane (Lengyel's oblique frustum)
+   * Everything between the virtual camera and the destination portal is clipped,
+   * the far plane tilts but depth stays monotonic.
+   * @param projection Perspective projection of the portal view
+   * @param view View matrix of the portal view
+   * @param clippingPlane Destination portal plane in world space
+   * @return Oblique projection, or projection unchanged when the camera touches the plane
+   */
+  static glm::mat4 obliqueProjection(
+      const glm::mat4& projection,
+      const glm::mat4& view,
+      const glm::vec4& clippingPlane);
+
 private:
   /**
    * Calculate relative transform between two portals
@@ -29,7 +29,8 @@ public:
 
   // Get framebuffer texture ID (for use in shaders)
   unsigned int getColorTexture() const { return colorTexture_; }
-  unsigned int getDepthTexture() const { return depthTexture_; }
+  // Depth is only tested, never sampled, so it lives in a renderbuffer
+  unsigned int getDepthRenderbuffer() const { return depthRenderbuffer_; }
 
   // Get dimensions
   int getWidth() const { return width_; }
@@ -53,7 +54,7 @@ private:
 
   unsigned int fbo_{0};
   unsigned int colorTexture_{0};
-  unsigned int depthTexture_{0};
+  unsigned int depthRenderbuffer_{0};
   int width_;
   int height_;
   bool valid_{false};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <system/Global.h>
+#include <render/PortalFramebuffer.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace omega {
+namespace render {
+
+/**
+ * PortalFramebufferPool - Render targets shared by all portal views
+ * A view asks for its screen footprint, each axis is rounded up to a power
+ * of two bucket so targets are reused as portals move. Targets go back to
+ * the pool when released or at the next reclaim(), ones left idle for a
+ * while are destroyed. Memory follows the portals visible at once, not the
+ * number of portals in the level.
+ */
+class OMEGA_EXPORT PortalFramebufferPool {
+public:
+  static constexpr int MIN_SIZE = 64;
+  // Frames a free target survives before its memory is given back
+  static constexpr int IDLE_FRAMES = 120;
+
+  PortalFramebufferPool() = default;
+
+  PortalFramebufferPool(const PortalFramebufferPool&) = delete;
+  PortalFramebufferPool& operator=(const PortalFramebufferPool&) = delete;
+
+  // Free target of the bucket holding size, created when none is left.
+  // A persistent target survives reclaim() until it is released.
+  PortalFramebuffer* acquire(const glm::ivec2& size, bool persistent = false);
+
+  // Hand a target back before the end of the frame
+  void release(PortalFramebuffer* framebuffer);
+
+  // Start of a frame: every target but persistent ones is free again, long idle ones are destroyed
+  void reclaim();
+
+  static glm::ivec2 bucket(const glm::ivec2& size);
+
+  size_t size() const { return targets_.size(); }
+
+private:
+  struct Target {
+    std::unique_ptr<PortalFramebuffer> framebuffer;
+    bool used{false};
+    bool persistent{false};
+    int idleFrames{0};
+  };
+
+  std::vector<Target> targets_;
+};
+
+}  // namespace render
+}  // namespace omega
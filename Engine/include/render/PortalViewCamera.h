@@ -17,12 +17,43 @@ public:
   PortalViewCamera(std::shared_ptr<Camera> baseCamera, const glm::mat4& customView);
   
   // Override view matrix to use custom portal view
-  glm::mat4 viewMatrix() const;
-  glm::mat4x4 projectionMatrix();
+  glm::mat4 viewMatrix() const override;
+  glm::mat4x4 projectionMatrix() override;
+
+  /**
+   * Replace the projection
+   * @param projection Regular perspective, nested portal views start from it
+   * @param clipped Projection rendered with, e.g. oblique at the destination portal
+   */
+  void setProjection(const glm::mat4& projection, const glm::mat4& clipped) {
+    unclippedProjection_ = projection;
+    projection_matrix_ = clipped;
+  }
+  glm::mat4 unclippedProjection() const { return unclippedProjection_; }
+
+  /**
+   * Limit culling to the portal's screen rectangle
+   * @param rect (x0, y0, x1, y1) in [0, 1], the frustum through the portal edges
+   * @param fit Also render with it, the rectangle then fills the whole target
+   */
+  void setScreenRect(const glm::vec4& rect, bool fit = false) {
+    screenRect_ = rect;
+    fitRect_ = fit;
+  }
+  glm::mat4x4 cullingProjection() override;
+
+  // Projection mapping the view onto the screen, regardless of the rectangle
+  glm::mat4x4 screenProjection() override { return projection_matrix_; }
+
+  // Clip space scale and offset that stretches a screen rectangle over [-1, 1]
+  static glm::mat4 narrowing(const glm::vec4& rect);
 
 private:
   std::shared_ptr<Camera> baseCamera_;
   glm::mat4 customView_;
+  glm::mat4 unclippedProjection_{1.0f};
+  glm::vec4 screenRect_{0.0f, 0.0f, 1.0f, 1.0f};
+  bool fitRect_{false};
 };
 
 }  // namespace render
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <system/Global.h>
+#include <cstdint>
+#include <vector>
+
+namespace omega {
+namespace render {
+
+/**
+ * RenderQueue - Per-view list of draws ordered by a 64-bit sort key
+ * From the top the key holds pass, program, texture set, vertex array, level
+ * of detail and a quantized front-to-back depth. After sort() draws sharing GL state are
+ * adjacent, so submission only pays for the state that actually changes.
+ *
+ * Passes are drawn in enum order. Blended draws must composite back to front,
+ * their key carries the reversed depth right below the pass instead.
+ */
+class OMEGA_EXPORT RenderQueue {
+public:
+  enum Pass : uint32_t {
+    SOLID = 0,
+    CUSTOM = 1,   // objects drawing themselves, they may leave any state behind
+    SKY = 2,      // after all opaque geometry, only fills uncovered pixels
+    BLENDED = 3,  // translucent materials, blending on and depth writes off
+  };
+
+  static constexpr int DEPTH_BITS = 18;
+  static constexpr int LOD_BITS = 2;
+  static constexpr int VAO_BITS = 12;
+  static constexpr int TEXTURE_BITS = 16;
+  static constexpr int PROGRAM_BITS = 12;
+  static constexpr int PASS_BITS = 4;
+  static_assert(DEPTH_BITS + LOD_BITS + VAO_BITS + TEXTURE_BITS + PROGRAM_BITS + PASS_BITS == 64, "sort key must fill 64 bits");
+
+  struct Item {
+    uint64_t key;
+    uint32_t index;
+  };
+
+  // depth is the view depth divided by the far plane, clamped to [0, 1]
+  static auto key(uint32_t pass, uint32_t program, uint32_t textureSet, uint32_t vao, uint32_t lod,
+                  float depth) -> uint64_t;
+
+  // Everything above the depth bits, equal state means no rebinding between two draws.
+  // Blended keys differ in depth as well.
+  static auto state(uint64_t key) -> uint64_t { return key >> DEPTH_BITS; }
+  static auto pass(uint64_t key) -> uint32_t { return static_cast<uint32_t>(key >> (64 - PASS_BITS)); }
+
+  void clear() { items_.clear(); }
+  void push(uint64_t key, uint32_t index) { items_.push_back({key, index}); }
+
+  // Stable LSD radix sort on the key
+  void sort();
+
+  auto items() const -> const std::vector<Item>& { return items_; }
+  auto size() const -> size_t { return items_.size(); }
+  auto empty() const -> bool { return items_.empty(); }
+
+private:
+  std::vector<Item> items_;
+  std::vector<Item> scratch_;
+};
+
+}  // namespace render
+}  // namespace omega
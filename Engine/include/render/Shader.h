@@ -1,8 +1,11 @@
 #pragma once
 
 #include <fstream>
+#include <initializer_list>
 #include <iostream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <system/Global.h>
 #include <geometry/Matrix.h>
@@ -18,7 +21,40 @@ namespace omega {
 namespace render {
 using namespace omega::geometry;
 
+// Location of an active uniform, resolved once when the program is linked.
+// A default constructed (or unknown) handle is ignored by the setters.
+struct UniformHandle {
+  int location{-1};
+
+  auto valid() const -> bool { return location >= 0; }
+};
+
+// Uniforms every object shader is expected to expose
+struct ObjectUniforms {
+  UniformHandle projection, view, model, viewPos, shininess;
+  UniformHandle instanced, instanceBase, batched, transparency, compactNormals;
+};
+
+struct PointLightUniforms {
+  UniformHandle position, ambient, diffuse, specular;
+  UniformHandle constant, linear, quadratic, on;
+};
+
+struct SpotLightUniforms {
+  UniformHandle position, direction, ambient, diffuse, specular;
+  UniformHandle constant, linear, quadratic, cutOff, outerCutOff, on;
+};
+
+struct DirectionalLightUniforms {
+  UniformHandle direction, ambient, diffuse, specular, on;
+};
+
 class OMEGA_EXPORT Shader {
+public:
+  static constexpr int MAX_POINT = 4;
+  static constexpr int MAX_SPOT = 4;
+  static constexpr int MAX_DIRECTIONAL = 4;
+
 private:
   unsigned int id{0};
   const int versionMajor;
@@ -32,9 +68,11 @@ private:
 							 const std::string& geometryCode = {});
   bool loadShadersFromFile(const std::string& vertexFile, const std::string& fragmentFile,
 						   const std::string& geometryFile = {});
+  bool loadComputeFromFile(const std::string& computeFile);
 
-  void linkProgram(unsigned int vertexShader, unsigned int geometryShader,
-				   unsigned int fragmentShader);
+  // Zero entries are skipped, a geometry stage is optional
+  void linkProgram(std::initializer_list<unsigned int> shaders);
+  void reflectUniforms();
 
 public:
   Shader(const int versionMajor, const int versionMinor);
@@ -47,6 +85,17 @@ public:
   // Set uniform functions
   void use();
   void unuse();
+
+  auto uniform(const std::string& name) const -> UniformHandle;
+
+  // Direct setters, the program must already be bound with use()
+  void set(UniformHandle handle, int value);
+  void set(UniformHandle handle, float value);
+  void set(UniformHandle handle, const glm::vec2& value);
+  void set(UniformHandle handle, const glm::vec3& value);
+  void set(UniformHandle handle, const glm::vec4& value);
+  void set(UniformHandle handle, const glm::mat4& value);
+
   void setInt(const std::string& name, int value);
   void setFloat(const std::string& name, float value);
   void setVec2(const std::string& name, glm::vec2 value);
@@ -66,6 +115,16 @@ public:
   auto getLightNumber(interface::LightType) -> int;
   auto turnOffLights() -> void;
 
+  auto usesFrameData() const -> bool { return frame_data_; }
+  auto usesClusteredLights() const -> bool { return clustered_lights_; }
+  auto supportsInstancing() const -> bool { return instancing_; }
+  auto programId() const -> unsigned int { return id; }
+  auto linked() const -> bool { return linked_; }
+  auto objectUniforms() const -> const ObjectUniforms& { return object_uniforms_; }
+  auto pointLight(int no) const -> const PointLightUniforms& { return point_light_uniforms_[no]; }
+  auto spotLight(int no) const -> const SpotLightUniforms& { return spot_light_uniforms_[no]; }
+  auto directionalLight(int no) const -> const DirectionalLightUniforms& { return dir_light_uniforms_[no]; }
+
   static std::shared_ptr<Shader> fromString(const int versionMajor,
 											const int versionMinor,
 											const std::string& vertexCode,
@@ -78,10 +137,25 @@ public:
 										  const std::string& fragmentFile,
 										  const std::string& geometryFile = {});
 
+  // Compute program, dispatched by the caller after use()
+  static std::shared_ptr<Shader> computeFromFile(const int versionMajor,
+												 const int versionMinor,
+												 const std::string& computeFile);
+
 private:
   unsigned int point_lights_{0};
   unsigned int spot_lights_{0};
   unsigned int directional_lights_{0};
+
+  std::unordered_map<std::string, int> uniforms_;
+  bool frame_data_{false};
+  bool clustered_lights_{false};
+  bool instancing_{false};
+  bool linked_{false};
+  ObjectUniforms object_uniforms_;
+  std::vector<PointLightUniforms> point_light_uniforms_;
+  std::vector<SpotLightUniforms> spot_light_uniforms_;
+  std::vector<DirectionalLightUniforms> dir_light_uniforms_;
 };
 
 }  // namespace render
@@ -42,6 +42,8 @@ class OMEGA_EXPORT SpotLight : public interface::Light {
   interface::LightType type() { return interface::LightType::SPOT; }
 
   void setup(std::shared_ptr<render::Shader>);
+  auto pack(interface::GpuLight&) -> bool override;
+  auto changed() -> bool override;
   void dump();
 
  private:
@@ -56,6 +58,10 @@ class OMEGA_EXPORT SpotLight : public interface::Light {
   float quadratic_;
   float cutOff_;
   float outerCutOff_;
+
+  // Pose of the tracked entity at the last pack()
+  glm::vec3 packedPosition_{0.0f};
+  glm::vec3 packedDirection_{0.0f};
 };
 };  // namespace render
 };  // namespace omega
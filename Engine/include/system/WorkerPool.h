@@ -0,0 +1,48 @@
+#pragma once
+
+#include <system/Global.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace omega {
+namespace system {
+
+/**
+ * WorkerPool - Fixed set of threads running parallel for loops
+ * run() hands out task indices to the workers and the calling thread and
+ * returns once every index has finished. Tasks are expected to be coarse,
+ * indices are taken under the pool's lock.
+ */
+class OMEGA_EXPORT WorkerPool {
+public:
+  // 0 uses one thread less than the hardware offers, the caller works too
+  explicit WorkerPool(unsigned int threads = 0);
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  // Call task(i) for i in [0, count), blocks until all calls returned
+  auto run(unsigned int count, const std::function<void(unsigned int)> &task) -> void;
+
+  inline auto threads() const -> unsigned int { return static_cast<unsigned int>(workers_.size()) + 1; }
+
+private:
+  auto work() -> void;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  const std::function<void(unsigned int)> *task_{nullptr};
+  unsigned int count_{0};
+  unsigned int next_{0};
+  unsigned int remaining_{0};
+  bool stop_{false};
+};
+
+}  // namespace system
+}  // namespace omega
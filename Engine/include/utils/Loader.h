@@ -27,12 +27,13 @@ namespace utils {
 
 class OMEGA_EXPORT Loader {
 public:
-  static auto loadModel(std::string path) -> ObjectNodePtr;
+  // flags are ObjectGenerator mesh flags, e.g. ogCompactVertices
+  static auto loadModel(std::string path, unsigned int flags = 0) -> ObjectNodePtr;
 
 private:
-  static auto processNode(aiNode *node, const aiScene *scene) -> ObjectNodePtr;
+  static auto processNode(aiNode *node, const aiScene *scene, unsigned int flags) -> ObjectNodePtr;
   static std::shared_ptr<geometry::Object> processMesh(std::string name, aiMesh *mesh,
-													   const aiScene *scene);
+													   const aiScene *scene, unsigned int flags);
   static std::map<std::string, std::shared_ptr<render::Texture>> loadMaterialTextures(aiMaterial *mat,
 																					  aiTextureType type,
 																					  std::string typeName);
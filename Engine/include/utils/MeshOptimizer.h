@@ -0,0 +1,49 @@
+#pragma once
+
+#include <system/Global.h>
+#include <geometry/Vertex.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace omega {
+namespace utils {
+
+// Post-transform cache efficiency of an index buffer under a simulated FIFO cache
+struct MeshStats {
+  float acmr{0.0f};  // vertex shader invocations per triangle
+  float atvr{0.0f};  // vertex shader invocations per unique vertex
+};
+
+/**
+ * MeshOptimizer - Import-time reordering of indexed triangle meshes
+ * optimize() welds identical vertices, reorders triangles for the vertex
+ * cache (Forsyth), orders cache-friendly clusters outside-in to cut overdraw
+ * and finally lays vertices out in first-use order for the fetch stage.
+ */
+class OMEGA_EXPORT MeshOptimizer {
+public:
+  static constexpr unsigned int CACHE_SIZE = 16;  // FIFO size used for the statistics
+
+  // Run every step and print ACMR/ATVR before and after
+  static auto optimize(std::vector<geometry::Vertex> &vertices, std::vector<unsigned int> &indices,
+					   const std::string &name) -> void;
+
+  // Merge bitwise identical vertices
+  static auto weld(std::vector<geometry::Vertex> &vertices, std::vector<unsigned int> &indices) -> void;
+
+  // Reorder triangles so recently used vertices are reused while still cached
+  static auto optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount) -> void;
+
+  // Reorder cache-friendly triangle clusters outside-in as long as ACMR grows by at most threshold
+  static auto optimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<geometry::Vertex> &vertices,
+							   float threshold = 1.05f) -> void;
+
+  // Renumber vertices in the order the index buffer first uses them
+  static auto optimizeVertexFetch(std::vector<geometry::Vertex> &vertices, std::vector<unsigned int> &indices) -> void;
+
+  static auto analyze(const std::vector<unsigned int> &indices, size_t vertexCount) -> MeshStats;
+};
+
+}  // namespace utils
+}  // namespace omega
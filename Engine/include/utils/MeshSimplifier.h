@@ -0,0 +1,33 @@
+#pragma once
+
+#include <system/Global.h>
+#include <geometry/Vertex.h>
+#include <vector>
+
+namespace omega {
+namespace utils {
+
+/**
+ * MeshSimplifier - Quadric error metric simplification
+ * Edges are collapsed onto one of their end points in order of the
+ * Garland-Heckbert error, so every level keeps indexing the original vertex
+ * buffer and levels of detail only differ in their index ranges. Open borders
+ * and attribute seams are locked, collapses flipping a triangle are rejected.
+ */
+class OMEGA_EXPORT MeshSimplifier {
+public:
+  // Meshes smaller than this keep a single level
+  static constexpr size_t MIN_LOD_INDICES = 3 * 256;
+
+  // Collapse until at most targetIndexCount indices remain or the next collapse
+  // would move the surface further than maxError
+  static auto simplify(const std::vector<geometry::Vertex> &vertices, const std::vector<unsigned int> &indices,
+					   size_t targetIndexCount, float maxError) -> std::vector<unsigned int>;
+
+  // Successive coarser index lists for LOD 1 and up, each cache optimized
+  static auto buildLods(const std::vector<geometry::Vertex> &vertices, const std::vector<unsigned int> &indices)
+  -> std::vector<std::vector<unsigned int>>;
+};
+
+}  // namespace utils
+}  // namespace omega
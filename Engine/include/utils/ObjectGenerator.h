@@ -5,6 +5,7 @@
 #include <render/CubeTexture.h>
 #include <interface/Light.h>
 #include <geometry/Vertex.h>
+#include <geometry/Box.h>
 #include <optional>
 #include <memory>
 #include <map>
@@ -34,13 +35,19 @@ struct ObjectGenerator {
 struct MeshInput {
   std::vector<omega::geometry::Vertex> vertices;
   std::vector<unsigned int> indices;
+  std::vector<std::vector<unsigned int>> lods;  // coarser index lists into the same vertices, see MeshSimplifier
   std::map<std::string, std::shared_ptr<omega::render::Texture>> textures;
   std::string name;
   unsigned int flags{0};
+  std::optional<omega::geometry::Box3<float>> bounds;
 };
 }  // namespace input
 
-enum { ogMirrorUV = 0x1 };
+enum {
+  ogMirrorUV = 0x1,
+  ogCompactVertices = 0x2,  // packed normals and half float uvs, see geometry/VertexLayout.h
+  ogNormalMap = 0x4,        // keep a packed tangent stream for normal mapping
+};
 
 class OMEGA_EXPORT ObjectGenerator {
 public:
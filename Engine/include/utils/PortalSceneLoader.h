@@ -4,6 +4,7 @@
 #include <geometry/Scene.h>
 #include <geometry/Portal.h>
 #include <geometry/PortalPair.h>
+#include <geometry/PortalRenderer.h>
 #include <render/Camera.h>
 #include <render/Shader.h>
 #include <render/Texture.h>
@@ -90,6 +91,9 @@ private:
   std::map<std::string, std::shared_ptr<render::Texture>> textures_;
   std::map<std::string, render::Material> materials_;
   CameraConfig cameraConfig_;
+  bool stencilPortals_{false};  // "portalMode": "stencil" renders portals without framebuffers
+  glm::ivec2 portalFramebufferSize_{0, 0};
+  geometry::PortalRenderer::UpdatePolicy portalUpdate_;  // "portalUpdate", temporal reuse of portal views
   
   // Helper methods for JSON parsing
   glm::vec3 parseVec3(const nlohmann::json& json, const std::string& key, glm::vec3 defaultValue = glm::vec3(0.0f));
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <system/Global.h>
+#include <functional>
+#include <memory>
+#include <map>
+#include <string>
+
+namespace omega {
+namespace utils {
+
+// GPU buffers of one generated primitive, shared by every object using it
+struct PrimitiveMesh {
+  unsigned int vao{0};
+  unsigned int vbo{0};
+  unsigned int count{0};
+};
+
+/**
+ * PrimitiveCache - Registry of generated primitive meshes
+ * ObjectGenerator builds each primitive once at unit size and shares its
+ * buffers; the requested size becomes a scale on the object instead. Only
+ * primitives whose texture coordinates depend on the size key on it. The
+ * buffers live as long as the GL context.
+ */
+class OMEGA_EXPORT PrimitiveCache {
+public:
+  PrimitiveCache() = default;
+
+  // Return the mesh stored under key, building it with create on first use
+  auto mesh(const std::string &key, const std::function<PrimitiveMesh()> &create) -> PrimitiveMesh;
+
+  // Upload interleaved vertices, either position/normal/uv or position only
+  static auto upload(const float *vertices, size_t size, unsigned int count, bool positionsOnly = false)
+  -> PrimitiveMesh;
+
+  static std::shared_ptr<PrimitiveCache> instance();
+
+private:
+  std::map<std::string, PrimitiveMesh> meshes_;
+};
+
+}  // namespace utils
+}  // namespace omega
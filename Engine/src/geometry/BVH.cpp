@@ -0,0 +1,259 @@
+#include <geometry/BVH.h>
+
+#include <algorithm>
+#include <utility>
+
+using namespace omega::geometry;
+
+void BVH::build(const std::vector<Box3<float>>& bounds, std::vector<uint32_t> slots) {
+  bounds_ = &bounds;
+  nodes_.clear();
+  slots_ = std::move(slots);
+
+  if (slots_.empty()) {
+    builtArea_ = 0.0f;
+    return;
+  }
+
+  nodes_.reserve(2 * slots_.size());
+  buildNode(0, static_cast<unsigned int>(slots_.size()));
+  builtArea_ = surfaceArea(nodes_[0].bounds);
+}
+
+auto BVH::buildNode(unsigned int first, unsigned int count) -> unsigned int {
+  unsigned int index = static_cast<unsigned int>(nodes_.size());
+  nodes_.push_back({Box3<float>::Invalid, first, count});
+
+  Box3<float> bounds = Box3<float>::Invalid;
+  Box3<float> centers = Box3<float>::Invalid;
+  for (unsigned int i = first; i < first + count; i++) {
+    auto& box = (*bounds_)[slots_[i]];
+    bounds.extend(box.minExtents);
+    bounds.extend(box.maxExtents);
+    centers.extend(box.getCenter());
+  }
+  nodes_[index].bounds = bounds;
+
+  if (count <= MAX_LEAF_OBJECTS)
+    return index;
+
+  // Median split on the axis where the object centers spread the most
+  int axis = 0;
+  auto spread = centers.getExtents();
+  if (spread.y > spread[axis])
+    axis = 1;
+  if (spread.z > spread[axis])
+    axis = 2;
+
+  unsigned int half = count / 2;
+  auto begin = slots_.begin() + first;
+  const auto& boxes = *bounds_;
+  std::nth_element(begin, begin + half, begin + count, [axis, &boxes](uint32_t a, uint32_t b) {
+    return boxes[a].getCenter()[axis] < boxes[b].getCenter()[axis];
+  });
+
+  // The left child lands directly after this node
+  buildNode(first, half);
+  unsigned int right = buildNode(first + half, count - half);
+  nodes_[index].offset = right;
+  nodes_[index].count = 0;
+  return index;
+}
+
+void BVH::refit() {
+  if (nodes_.empty())
+    return;
+
+  // Children always follow their parent, so a reverse sweep sees them first
+  for (size_t i = nodes_.size(); i-- > 0;) {
+    auto& node = nodes_[i];
+    Box3<float> bounds = Box3<float>::Invalid;
+    if (node.count > 0) {
+      for (unsigned int j = node.offset; j < node.offset + node.count; j++) {
+        auto& box = (*bounds_)[slots_[j]];
+        bounds.extend(box.minExtents);
+        bounds.extend(box.maxExtents);
+      }
+    } else {
+      for (auto* child : {&nodes_[i + 1], &nodes_[node.offset]}) {
+        bounds.extend(child->bounds.minExtents);
+        bounds.extend(child->bounds.maxExtents);
+      }
+    }
+    node.bounds = bounds;
+  }
+
+  // Slots drifting apart make the refitted boxes overlap, rebuild once the
+  // root has grown well past its original size
+  if (surfaceArea(nodes_[0].bounds) > 2.0f * builtArea_) {
+    auto slots = slots_;
+    build(*bounds_, std::move(slots));
+  }
+}
+
+void BVH::clear() {
+  bounds_ = nullptr;
+  nodes_.clear();
+  slots_.clear();
+  builtArea_ = 0.0f;
+}
+
+auto BVH::bounds() const -> const Box3<float>& {
+  return nodes_.empty() ? Box3<float>::Zero : nodes_[0].bounds;
+}
+
+auto BVH::surfaceArea(const Box3<float>& box) -> float {
+  auto e = box.getExtents();
+  return 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+}
+
+void BVH::cull(const Frustum& frustum, std::vector<uint32_t>& visible) const {
+  if (!nodes_.empty())
+    cullNode(0, frustum, 0x3f, visible);
+}
+
+void BVH::cullNode(unsigned int index, const Frustum& frustum, unsigned int planeMask,
+                   std::vector<uint32_t>& visible) const {
+  const auto& node = nodes_[index];
+  const auto& box = node.bounds;
+
+  for (unsigned int i = 0; i < 6; i++) {
+    if (!(planeMask & (1u << i)))
+      continue;
+
+    const auto& plane = frustum[i];
+    Point3<float> outer(plane.x >= 0 ? box.maxExtents.x : box.minExtents.x,
+                      plane.y >= 0 ? box.maxExtents.y : box.minExtents.y,
+                      plane.z >= 0 ? box.maxExtents.z : box.minExtents.z);
+    if (plane.distTPlane(outer) < 0)
+      return;
+
+    // Fully on the inner side, children need not test this plane again
+    Point3<float> inner(plane.x >= 0 ? box.minExtents.x : box.maxExtents.x,
+                       plane.y >= 0 ? box.minExtents.y : box.maxExtents.y,
+                       plane.z >= 0 ? box.minExtents.z : box.maxExtents.z);
+    if (plane.distTPlane(inner) >= 0)
+      planeMask &= ~(1u << i);
+  }
+
+  if (planeMask == 0) {
+    appendLeaves(index, visible);
+    return;
+  }
+
+  if (node.count > 0) {
+    for (unsigned int i = node.offset; i < node.offset + node.count; i++)
+      visible.push_back(slots_[i]);
+    return;
+  }
+
+  cullNode(index + 1, frustum, planeMask, visible);
+  cullNode(node.offset, frustum, planeMask, visible);
+}
+
+void BVH::appendLeaves(unsigned int index, std::vector<uint32_t>& visible) const {
+  const auto& node = nodes_[index];
+  if (node.count > 0) {
+    for (unsigned int i = node.offset; i < node.offset + node.count; i++)
+      visible.push_back(slots_[i]);
+    return;
+  }
+  appendLeaves(index + 1, visible);
+  appendLeaves(node.offset, visible);
+}
+
+auto BVH::raycast(const Point3<float>& start, const Point3<float>& end, float* t) const -> uint32_t {
+  uint32_t hit = NONE;
+  float best = 1.0f;
+  if (nodes_.empty())
+    return hit;
+
+  // A box the segment starts in counts as entered at t = 0
+  auto enter = [&start, &end](const Box3<float>& box, float& at) {
+    if (box.isContained(start)) {
+      at = 0.0f;
+      return true;
+    }
+    Point3<float> normal;
+    return box.collideLine(start, end, &at, &normal);
+  };
+
+  std::vector<unsigned int> stack{0};
+  while (!stack.empty()) {
+    const auto& node = nodes_[stack.back()];
+    unsigned int index = stack.back();
+    stack.pop_back();
+
+    float at;
+    if (!enter(node.bounds, at) || at > best)
+      continue;
+
+    if (node.count > 0) {
+      for (unsigned int i = node.offset; i < node.offset + node.count; i++) {
+        if (enter((*bounds_)[slots_[i]], at) && at <= best) {
+          best = at;
+          hit = slots_[i];
+        }
+      }
+      continue;
+    }
+
+    stack.push_back(node.offset);
+    stack.push_back(index + 1);
+  }
+
+  if (hit != NONE && t)
+    *t = best;
+  return hit;
+}
+
+void BVH::query(const Box3<float>& box, std::vector<uint32_t>& result) const {
+  if (nodes_.empty())
+    return;
+
+  std::vector<unsigned int> stack{0};
+  while (!stack.empty()) {
+    unsigned int index = stack.back();
+    stack.pop_back();
+    const auto& node = nodes_[index];
+    if (!node.bounds.isOverlapped(box))
+      continue;
+
+    if (node.count > 0) {
+      for (unsigned int i = node.offset; i < node.offset + node.count; i++) {
+        if ((*bounds_)[slots_[i]].isOverlapped(box))
+          result.push_back(slots_[i]);
+      }
+      continue;
+    }
+
+    stack.push_back(node.offset);
+    stack.push_back(index + 1);
+  }
+}
+
+void BVH::query(const Sphere<float>& sphere, std::vector<uint32_t>& result) const {
+  if (nodes_.empty())
+    return;
+
+  float radiusSq = sphere.radius * sphere.radius;
+  std::vector<unsigned int> stack{0};
+  while (!stack.empty()) {
+    unsigned int index = stack.back();
+    stack.pop_back();
+    const auto& node = nodes_[index];
+    if (node.bounds.getSqDistanceTPoint(sphere.center) > radiusSq)
+      continue;
+
+    if (node.count > 0) {
+      for (unsigned int i = node.offset; i < node.offset + node.count; i++) {
+        if ((*bounds_)[slots_[i]].getSqDistanceTPoint(sphere.center) <= radiusSq)
+          result.push_back(slots_[i]);
+      }
+      continue;
+    }
+
+    stack.push_back(node.offset);
+    stack.push_back(index + 1);
+  }
+}
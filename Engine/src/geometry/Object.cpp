@@ -2,7 +2,10 @@
 // Created by Carsten Tang on 13/08/2023.
 //
 #include "geometry/Object.h"
+#include <geometry/SceneTables.h>
+#include <geometry/VertexLayout.h>
 #include <render/Camera.h>
+#include <render/GLState.h>
 #include <render/Shader.h>
 #include <render/Texture.h>
 
@@ -33,45 +36,126 @@ void Object::render(std::shared_ptr<render::Camera> camera) {
 	return;
   }
 
-  shader_->setMat4fv("projection", camera->projectionMatrix());
-  shader_->setMat4fv("view", camera->viewMatrix());
-  shader_->setMat4fv("model", model_);
-  
-  // Set viewPos for lighting calculations
-  shader_->setVec3("viewPos", camera->position());
+  auto& uniforms = shader_->objectUniforms();
+  shader_->use();
+  shader_->set(uniforms.model, world_);
+  if (uniforms.instanced.valid())
+	shader_->set(uniforms.instanced, 0);
+  shader_->set(uniforms.compactNormals, mesh_buffers_.format!=VertexFormat::Full ? 1 : 0);
+
+  // Camera state comes from the FrameData block, only legacy programs
+  // still declare the loose uniforms
+  if (uniforms.projection.valid())
+	shader_->set(uniforms.projection, camera->projectionMatrix());
+  if (uniforms.view.valid())
+	shader_->set(uniforms.view, camera->viewMatrix());
+  if (uniforms.viewPos.valid())
+	shader_->set(uniforms.viewPos, camera->position());
 
   if (material_)
-	shader_->setFloat("material.shininess", material_.value().shininess);
+	shader_->set(uniforms.shininess, material_.value().shininess);
 
   for (int no = 0; no < textures_.size(); no++)
 	textures_.at(no)->activate(no);
 
-  shader_->resetCounters();
-  shader_->turnOffLights();
-  for (auto light : lights_) {
-	light->setup(shader_);
+  // Clustered programs read the scene lights from the light buffers
+  if (!shader_->usesClusteredLights()) {
+	shader_->resetCounters();
+	shader_->turnOffLights();
+	for (auto light : lights_) {
+	  light->setup(shader_);
+	}
   }
 
-  shader_->use();
+  drawParams().draw();
+}
 
-  glBindVertexArray(vao_);
-  switch (type_) {
+auto DrawParams::draw() const -> void {
+  render::GLState::bindVertexArray(vao);
+  switch (type) {
   case ObjectType::Elements:
-	glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(count_),
-				   GL_UNSIGNED_INT, 0);
+	glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(count),
+				   indexGLType(indices), reinterpret_cast<const void *>(size_t(first) * indexSize(indices)));
 	break;
-  case ObjectType::Array:glDrawArrays(GL_TRIANGLES, 0, count_);
+  case ObjectType::Array:glDrawArrays(GL_TRIANGLES, first, count);
+	break;
+  }
+}
+
+auto DrawParams::drawInstanced(unsigned int instances) const -> void {
+  render::GLState::bindVertexArray(vao);
+  switch (type) {
+  case ObjectType::Elements:
+	glDrawElementsInstanced(GL_TRIANGLES, static_cast<unsigned int>(count),
+							indexGLType(indices), reinterpret_cast<const void *>(size_t(first) * indexSize(indices)),
+							instances);
+	break;
+  case ObjectType::Array:glDrawArraysInstanced(GL_TRIANGLES, first, count, instances);
 	break;
   }
-  glBindVertexArray(0);
 }
 
 auto Object::position(glm::vec3 pos) -> void {
   model_ = glm::translate(model_, pos);
+  updateWorld();
 }
 
 auto Object::scale(float value) -> void {
   model_ = glm::scale(model_, glm::vec3(value));
+  updateWorld();
+}
+
+auto Object::setBounds(const Box3<float> &box) -> void {
+  local_box_ = box;
+  local_sphere_ = Sphere<float>(box.getCenter(), (box.maxExtents - box.minExtents).len()*0.5f);
+  has_bounds_ = true;
+  updateWorld();
+}
+
+auto Object::stateChanged() -> void {
+  if (tables_)
+	tables_->syncState(slot_);
+}
+
+auto Object::setParentTransform(const glm::mat4 &parent) -> void {
+  parent_ = parent;
+  has_parent_ = parent!=glm::mat4(1.0f);
+  updateWorld();
+}
+
+auto Object::setMeshScale(const glm::vec3 &scale) -> void {
+  mesh_scale_ = scale;
+  has_mesh_scale_ = scale!=glm::vec3(1.0f);
+  updateWorld();
+}
+
+auto Object::updateWorld() -> void {
+  world_ = has_parent_ ? parent_*model_ : model_;
+  if (has_mesh_scale_)
+	world_ = glm::scale(world_, mesh_scale_);
+
+  if (has_bounds_) {
+	// Transform the box center and fold the absolute rotation/scale into the extents
+	auto center = local_box_.getCenter();
+	auto half = local_box_.getExtents()*0.5f;
+	glm::vec3 worldCenter = glm::vec3(world_*glm::vec4(center.x, center.y, center.z, 1.0f));
+	glm::vec3 worldHalf(0.0f);
+	for (int axis = 0; axis < 3; axis++)
+	  worldHalf += glm::abs(glm::vec3(world_[axis]))*half[axis];
+
+	world_box_.set(worldCenter.x - worldHalf.x, worldCenter.y - worldHalf.y, worldCenter.z - worldHalf.z,
+				   worldCenter.x + worldHalf.x, worldCenter.y + worldHalf.y, worldCenter.z + worldHalf.z);
+
+	auto sphereCenter = glm::vec3(world_*glm::vec4(local_sphere_.center.x, local_sphere_.center.y,
+													local_sphere_.center.z, 1.0f));
+	float maxScale = glm::max(glm::length(glm::vec3(world_[0])),
+							  glm::max(glm::length(glm::vec3(world_[1])), glm::length(glm::vec3(world_[2]))));
+	world_sphere_ = Sphere<float>(Point3<float>(sphereCenter.x, sphereCenter.y, sphereCenter.z),
+								  local_sphere_.radius*maxScale);
+  }
+
+  if (tables_)
+	tables_->syncTransform(slot_);
 }
 
 auto Object::setupPhysics(reactphysics3d::PhysicsWorld *world,
@@ -79,7 +163,8 @@ auto Object::setupPhysics(reactphysics3d::PhysicsWorld *world,
   if (!physicsObject_.isActive)
 	return;
   reactphysics3d::Transform transform;
-  transform.setFromOpenGL(glm::value_ptr(model_));
+  glm::mat4 placement = has_parent_ ? parent_*model_ : model_;
+  transform.setFromOpenGL(glm::value_ptr(placement));
 
   body_ = world->createRigidBody(transform);
   body_->setType((reactphysics3d::BodyType)physicsObject_.bodyType);
@@ -126,6 +211,9 @@ auto Object::process() -> void {
 	auto transform = body_->getTransform();
 	float mat[16];
 	transform.getOpenGLMatrix(mat);
-	model_ = glm::make_mat4(mat);
+
+	// The body lives in world space, keep model_ relative to the parent node
+	model_ = has_parent_ ? glm::inverse(parent_)*glm::make_mat4(mat) : glm::make_mat4(mat);
+	updateWorld();
   }
 }
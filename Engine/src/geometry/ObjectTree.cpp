@@ -12,6 +12,35 @@ using namespace std;
 using namespace omega::render;
 using namespace omega::interface;
 
+auto ObjectNode::setTransform(const glm::mat4x4 &local) -> void {
+  mat = local;
+  dirty = true;
+  for (auto node = parent; node && !node->childDirty; node = node->parent)
+	node->childDirty = true;
+}
+
+auto ObjectNode::updateTransforms(const glm::mat4x4 &parentWorld, bool parentChanged) -> bool {
+  bool changed = dirty || parentChanged;
+  if (!changed && !childDirty)
+	return false;
+
+  if (changed) {
+	world = parentWorld*mat;
+	for (auto &mesh : meshes)
+	  mesh->setParentTransform(world);
+  }
+
+  bool moved = changed;
+  for (auto &child : children) {
+	child->parent = this;
+	moved |= child->updateTransforms(world, changed);
+  }
+
+  dirty = false;
+  childDirty = false;
+  return moved;
+}
+
 ObjectTree::ObjectTree() {
 }
 
@@ -4,6 +4,7 @@
 #include <geometry/PortalSurface.h>
 #include <geometry/Scene.h>
 #include <render/Camera.h>
+#include <render/GLState.h>
 #include <render/PortalFramebuffer.h>
 #include <render/PortalCamera.h>
 #include <render/PortalViewCamera.h>
@@ -14,11 +15,30 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/constants.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace omega::geometry;
 using namespace omega::render;
 
+// Screen rectangles are (x0, y0, x1, y1) in [0, 1] of the target
+static const glm::vec4 FULL_SCREEN(0.0f, 0.0f, 1.0f, 1.0f);
+
+// Scene view key of the view through a portal, the chain of portals it is
+// seen through identifies it from frame to frame
+static uint64_t portalViewKey(uint64_t parentView, const std::shared_ptr<Portal>& portal) {
+  uint64_t key = reinterpret_cast<uintptr_t>(portal.get());
+  return parentView ^ (key + 0x9e3779b97f4a7c15ull + (parentView << 6) + (parentView >> 2));
+}
+
 PortalRenderer::PortalRenderer() = default;
 
+PortalRenderer::~PortalRenderer() {
+  for (auto& [portal, query] : queries_) {
+    glDeleteQueries(1, &query.id);
+  }
+}
+
 void PortalRenderer::addPortalPair(std::shared_ptr<PortalPair> portalPair) {
   if (portalPair && portalPair->isValid()) {
     portalPairs_.push_back(portalPair);
@@ -36,8 +56,20 @@ void PortalRenderer::renderPortals(std::shared_ptr<Scene> scene,
     return;
   }
 
+  // Last frame's views are done with, their targets go back to the pool.
+  // Cached outermost views keep theirs.
+  framebufferPool_.reclaim();
+  portalViews_.clear();
+  frame_++;
+  viewsRendered_ = 0;
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  screenViewport_ = glm::ivec4(viewport[0], viewport[1], viewport[2], viewport[3]);
+
   // Render portal views first (to framebuffers)
   // This happens BEFORE the main scene so we can use the framebuffers when rendering surfaces
+  std::vector<ViewRequest> requests;
   for (auto& portalPair : portalPairs_) {
     if (!portalPair->isEnabled()) {
       continue;
@@ -52,14 +84,33 @@ void PortalRenderer::renderPortals(std::shared_ptr<Scene> scene,
 
     // Render portal A's view (what you see through portal A)
     if (isPortalVisible(portalA, playerCamera) && portalA->isEnabled()) {
-      renderPortalView(portalA, portalB, scene, playerCamera, 0);
+      queueOutermostView(portalA, portalB, playerCamera, requests);
     }
 
     // Render portal B's view (what you see through portal B)
     if (isPortalVisible(portalB, playerCamera) && portalB->isEnabled()) {
-      renderPortalView(portalB, portalA, scene, playerCamera, 0);
+      queueOutermostView(portalB, portalA, playerCamera, requests);
     }
   }
+
+  // Changed views first, then the ones waiting longest for a refresh, so
+  // portals take turns when the budget runs out
+  std::stable_sort(requests.begin(), requests.end(), [](const ViewRequest& a, const ViewRequest& b) {
+    return a.changed != b.changed ? a.changed : a.age > b.age;
+  });
+  for (auto& request : requests) {
+    renderOutermostView(request, scene, playerCamera);
+  }
+
+  // Portals out of sight for long give their last image back
+  for (auto it = cachedViews_.begin(); it != cachedViews_.end();) {
+    if (frame_ - it->second.lastSeen <= static_cast<uint64_t>(PortalFramebufferPool::IDLE_FRAMES)) {
+      ++it;
+      continue;
+    }
+    framebufferPool_.release(it->second.view.framebuffer);
+    it = cachedViews_.erase(it);
+  }
   
   // Ensure viewport is restored to window size after portal view rendering
   GLFWwindow* currentWindow = glfwGetCurrentContext();
@@ -97,7 +148,7 @@ void PortalRenderer::renderPortalSurfaces(std::shared_ptr<Camera> playerCamera,
         glm::vec3 posA = portalA->getPosition();
         std::cout << "[Portal] Rendering portal A at (" << posA.x << ", " << posA.y << ", " << posA.z << ")" << std::endl;
       }
-      renderPortalSurface(portalA, playerCamera, portalShader);
+      renderQueriedSurface(portalA, playerCamera, portalShader);
     }
 
     if (portalB && portalB->isVisible() && portalB->isEnabled()) {
@@ -106,114 +157,472 @@ void PortalRenderer::renderPortalSurfaces(std::shared_ptr<Camera> playerCamera,
         glm::vec3 posB = portalB->getPosition();
         std::cout << "[Portal] Rendering portal B at (" << posB.x << ", " << posB.y << ", " << posB.z << ")" << std::endl;
       }
-      renderPortalSurface(portalB, playerCamera, portalShader);
+      renderQueriedSurface(portalB, playerCamera, portalShader);
     }
   }
 }
 
-void PortalRenderer::renderPortalView(std::shared_ptr<Portal> sourcePortal,
-                                     std::shared_ptr<Portal> destPortal,
-                                     std::shared_ptr<Scene> scene,
-                                     std::shared_ptr<Camera> playerCamera,
-                                     int recursionDepth) {
-  if (!sourcePortal || !destPortal || !scene || !playerCamera) {
+void PortalRenderer::queueOutermostView(std::shared_ptr<Portal> sourcePortal,
+                                        std::shared_ptr<Portal> destPortal,
+                                        std::shared_ptr<Camera> playerCamera,
+                                        std::vector<ViewRequest>& requests) {
+  ViewRequest request;
+  request.source = sourcePortal;
+  request.dest = destPortal;
+  if (!portalScreenRect(sourcePortal, playerCamera, FULL_SCREEN, request.rect)) {
     return;
   }
 
-  // Prevent infinite recursion
-  if (recursionDepth >= maxRecursionDepth_) {
+  // Hidden behind other geometry last frame, its surface query keeps running
+  auto query = queries_.find(sourcePortal);
+  if (query != queries_.end() && query->second.issued) {
+    GLuint available = 0;
+    glGetQueryObjectuiv(query->second.id, GL_QUERY_RESULT_AVAILABLE, &available);
+    GLuint samples = 1;
+    if (available) {
+      glGetQueryObjectuiv(query->second.id, GL_QUERY_RESULT, &samples);
+    }
+    if (samples == 0) {
+      return;
+    }
+    request.query = query->second.id;
+    request.confirmed = available != 0;
+  }
+
+  // Camera relative to the source portal, what the view depends on besides the destination
+  request.pose = glm::inverse(sourcePortal->getTransform()) * glm::inverse(playerCamera->viewMatrix());
+  request.destTransform = destPortal->getTransform();
+
+  auto cached = cachedViews_.find(sourcePortal);
+  if (cached == cachedViews_.end()) {
+    request.changed = true;
+  } else {
+    const auto& last = cached->second;
+    glm::vec4 rectDelta = glm::abs(request.rect - last.view.rect);
+    request.changed = transformChanged(request.pose, last.pose) ||
+                      transformChanged(request.destTransform, last.destTransform) ||
+                      glm::max(glm::max(rectDelta.x, rectDelta.y), glm::max(rectDelta.z, rectDelta.w)) >
+                          updatePolicy_.rectThreshold;
+    request.age = frame_ - last.frame;
+  }
+  requests.push_back(request);
+}
+
+void PortalRenderer::renderOutermostView(const ViewRequest& request,
+                                         std::shared_ptr<Scene> scene,
+                                         std::shared_ptr<Camera> playerCamera) {
+  // Unchanged views wait for their refresh, every view waits once the budget
+  // is spent. Without an image yet the portal stays undrawn until there is room.
+  auto cached = cachedViews_.find(request.source);
+  bool affordable = withinBudget(0);
+  if (cached != cachedViews_.end()) {
+    cached->second.lastSeen = frame_;
+    bool due = request.changed || request.age >= static_cast<uint64_t>(updatePolicy_.refreshInterval);
+    // A result still in flight may yet say hidden, the last image stands in until it lands
+    bool unconfirmed = request.query && !request.confirmed;
+    if (!due || !affordable || unconfirmed) {
+      portalViews_[request.source] = cached->second.view;
+      return;
+    }
+  } else if (!affordable) {
     return;
   }
 
-  auto framebuffer = sourcePortal->getFramebuffer();
-  if (!framebuffer || !framebuffer->isComplete()) {
+  // Without an image yet the GPU decides, a view it skips shows the clear color
+  unsigned int condition = request.confirmed ? 0 : request.query;
+  auto view = renderPortalView(request.source, request.dest, scene, playerCamera, request.rect, 0,
+                               Scene::MAIN_VIEW, condition);
+  if (!view.framebuffer) {
     return;
   }
 
-  // Bind portal framebuffer
-  framebuffer->bind();
-  // Clear to a visible color to test framebuffer rendering
-  // Use a blue-green color so we can see if framebuffer is working
-  framebuffer->clear(0.2f, 0.5f, 0.8f, 1.0f);  // Blue-green background
+  // A view the GPU may have skipped is only a stand-in, it is due again next frame
+  CachedView entry;
+  entry.view = view;
+  entry.pose = request.pose;
+  entry.destTransform = request.destTransform;
+  entry.lastSeen = frame_;
+  if (cached != cachedViews_.end()) {
+    framebufferPool_.release(cached->second.view.framebuffer);
+    entry.frame = frame_;
+  } else {
+    // New views are spread over the refresh interval so they take turns
+    entry.frame = frame_ - cachedViews_.size() % std::max(updatePolicy_.refreshInterval, 1);
+  }
+  if (condition) {
+    entry.frame = 0;
+  }
+  cachedViews_[request.source] = entry;
+  portalViews_[request.source] = view;
+}
 
-  // Calculate portal camera view matrix
-  glm::mat4 portalView = PortalCamera::calculatePortalView(
-      *playerCamera, *sourcePortal, *destPortal);
+bool PortalRenderer::withinBudget(int pending) const {
+  return updatePolicy_.viewBudget <= 0 || viewsRendered_ + pending < updatePolicy_.viewBudget;
+}
 
-  // Create temporary camera with portal view
-  auto portalCamera = std::make_shared<PortalViewCamera>(playerCamera, portalView);
-  
-  // Fix aspect ratio: framebuffer might be square (1024x1024) but window is 16:9
-  // Create a projection matrix that matches the framebuffer's aspect ratio
-  float framebufferAspect = static_cast<float>(framebuffer->getWidth()) / static_cast<float>(framebuffer->getHeight());
-  glm::mat4 baseProjection = playerCamera->projectionMatrix();
-  
-  // Extract FOV and near/far from base projection (assuming perspective)
-  // For perspective matrices, we can extract the FOV from the top component
-  float fov = 45.0f; // Default, will be extracted if possible
-  float nearPlane = 0.1f;
-  float farPlane = 100.0f;
-  
-  // Try to extract from base camera if it's a CameraFPS or similar
-  // For now, create a new projection with correct aspect ratio
-  // We'll use the same FOV as the base camera but adjust aspect
-  portalCamera->setPerspective(45.0f, 
-                               static_cast<float>(framebuffer->getWidth()),
-                               static_cast<float>(framebuffer->getHeight()),
-                               nearPlane, farPlane);
-
-  // Render scene from portal perspective
-  // Note: This renders the scene objects, but NOT portals recursively (to avoid infinite recursion)
-  static int renderCount = 0;
-  if (renderCount++ < 3) {
-    glm::vec3 camPos = portalCamera->position();
-    glm::vec3 playerPos = playerCamera->position();
-    glm::vec3 sourcePos = sourcePortal->getPosition();
-    glm::vec3 destPos = destPortal->getPosition();
-    glm::vec3 camFront = portalCamera->front();
-    glm::mat4 view = portalCamera->viewMatrix();
-    glm::mat4 proj = portalCamera->projectionMatrix();
-    std::cout << "[Portal] Rendering view:" << std::endl;
-    std::cout << "  Player pos: (" << playerPos.x << "," << playerPos.y << "," << playerPos.z << ")" << std::endl;
-    std::cout << "  Source portal pos: (" << sourcePos.x << "," << sourcePos.y << "," << sourcePos.z << ")" << std::endl;
-    std::cout << "  Dest portal pos: (" << destPos.x << "," << destPos.y << "," << destPos.z << ")" << std::endl;
-    std::cout << "  Portal camera pos: (" << camPos.x << "," << camPos.y << "," << camPos.z << ")" << std::endl;
-    std::cout << "  Portal camera front: (" << camFront.x << "," << camFront.y << "," << camFront.z << ")" << std::endl;
-    std::cout << "  Framebuffer size: " << framebuffer->getWidth() << "x" << framebuffer->getHeight() << std::endl;
+bool PortalRenderer::transformChanged(const glm::mat4& current, const glm::mat4& last) const {
+  if (glm::length(glm::vec3(current[3]) - glm::vec3(last[3])) > updatePolicy_.positionThreshold) {
+    return true;
   }
-  
-  // Ensure we're rendering to the framebuffer
-  GLenum err = glGetError();
-  if (err != GL_NO_ERROR) {
-    std::cerr << "[Portal] GL Error before scene render: " << err << std::endl;
+
+  // Largest rotation of any axis
+  float cosine = 1.0f;
+  for (int axis = 0; axis < 3; axis++) {
+    cosine = std::min(cosine, glm::dot(glm::normalize(glm::vec3(current[axis])),
+                                       glm::normalize(glm::vec3(last[axis]))));
   }
-  
-  // Check framebuffer status
-  GLenum fbStatus = glCheckFramebufferStatus(GL_FRAMEBUFFER);
-  if (fbStatus != GL_FRAMEBUFFER_COMPLETE) {
-    std::cerr << "[Portal] Framebuffer not complete! Status: " << fbStatus << std::endl;
+  return cosine < std::cos(glm::radians(updatePolicy_.angleThreshold));
+}
+
+void PortalRenderer::renderQueriedSurface(std::shared_ptr<Portal> portal,
+                                          std::shared_ptr<Camera> playerCamera,
+                                          std::shared_ptr<Shader> portalShader) {
+  auto& query = queries_[portal];
+  if (!isPortalVisible(portal, playerCamera)) {
+    query.issued = false;
+    return;
   }
-  
-  scene->render(portalCamera);
-  
-  // Check for errors after rendering
-  err = glGetError();
-  if (err != GL_NO_ERROR) {
-    std::cerr << "[Portal] GL Error after scene render: " << err << std::endl;
+  if (query.id == 0) {
+    glGenQueries(1, &query.id);
+  }
+
+  // Counts the surface's visible samples for next frame's portal views. A
+  // portal skipped as hidden has no view, its bare quad is tested instead.
+  glBeginQuery(GL_ANY_SAMPLES_PASSED, query.id);
+  auto view = portalViews_.find(portal);
+  if (view != portalViews_.end()) {
+    renderPortalSurface(portal, playerCamera, portalShader, view->second);
+  } else {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glEnable(GL_POLYGON_OFFSET_FILL);
+    glPolygonOffset(-1.0f, -1.0f);
+    drawPortalMask(portal, playerCamera->projectionMatrix() * playerCamera->viewMatrix());
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDepthMask(GL_TRUE);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  }
+  glEndQuery(GL_ANY_SAMPLES_PASSED);
+  query.issued = true;
+}
+
+void PortalRenderer::renderStencilPortals(std::shared_ptr<Scene> scene,
+                                          std::shared_ptr<Camera> playerCamera) {
+  if (!enabled_ || !scene || !playerCamera) {
+    return;
+  }
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  glm::ivec4 target(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+  glEnable(GL_STENCIL_TEST);
+  glEnable(GL_SCISSOR_TEST);
+  glStencilMask(0xFF);
+  for (auto& portalPair : portalPairs_) {
+    if (!portalPair->isEnabled()) {
+      continue;
+    }
+
+    auto portalA = portalPair->getPortalA();
+    auto portalB = portalPair->getPortalB();
+    if (!portalA || !portalB) {
+      continue;
+    }
+
+    glm::vec4 rect;
+    if (portalA->isEnabled() && portalA->isVisible() && isPortalVisible(portalA, playerCamera) &&
+        portalScreenRect(portalA, playerCamera, FULL_SCREEN, rect)) {
+      renderStencilView(portalA, portalB, scene, playerCamera, rect, target, 0);
+    }
+    if (portalB->isEnabled() && portalB->isVisible() && isPortalVisible(portalB, playerCamera) &&
+        portalScreenRect(portalB, playerCamera, FULL_SCREEN, rect)) {
+      renderStencilView(portalB, portalA, scene, playerCamera, rect, target, 0);
+    }
+  }
+  glStencilFunc(GL_ALWAYS, 0, 0xFF);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+  glDisable(GL_SCISSOR_TEST);
+  glDisable(GL_STENCIL_TEST);
+}
+
+void PortalRenderer::renderStencilView(std::shared_ptr<Portal> sourcePortal,
+                                       std::shared_ptr<Portal> destPortal,
+                                       std::shared_ptr<Scene> scene,
+                                       std::shared_ptr<Camera> camera,
+                                       const glm::vec4& rect,
+                                       const glm::ivec4& target,
+                                       int level,
+                                       uint64_t parentView) {
+  // Stencil values are 8 bit, one per level
+  if (level >= maxRecursionDepth_ || level >= 0xFF) {
+    return;
+  }
+
+  // Nothing this level draws leaves the portal's rectangle
+  glm::ivec4 scissor = pixelRect(rect, target);
+  glScissor(scissor.x, scissor.y, scissor.z, scissor.w);
+
+  glm::mat4 viewProjection = camera->projectionMatrix() * camera->viewMatrix();
+
+  // Mark the portal's visible pixels inside the parent level. The quad sits
+  // on its wall, the offset keeps it in front of it.
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+  glDepthMask(GL_FALSE);
+  glDepthFunc(GL_LEQUAL);
+  glEnable(GL_POLYGON_OFFSET_FILL);
+  glPolygonOffset(-1.0f, -1.0f);
+  glStencilFunc(GL_EQUAL, level, 0xFF);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
+
+  // The mark's own samples decide whether the rest of the level is drawn.
+  // The GPU waits for them, the CPU does not.
+  GLuint markQuery = 0;
+  if (level == 0) {
+    auto& query = queries_[sourcePortal];
+    if (query.id == 0) {
+      glGenQueries(1, &query.id);
+    }
+    markQuery = query.id;
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, markQuery);
+  }
+  drawPortalMask(sourcePortal, viewProjection);
+  if (markQuery) {
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+    glBeginConditionalRender(markQuery, GL_QUERY_BY_REGION_WAIT);
+  }
+  glDisable(GL_POLYGON_OFFSET_FILL);
+
+  // Push the marked pixels to the far plane so the wall does not hide the view
+  glStencilFunc(GL_EQUAL, level + 1, 0xFF);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+  glDepthMask(GL_TRUE);
+  glDepthFunc(GL_ALWAYS);
+  glDepthRange(1.0, 1.0);
+  drawPortalMask(sourcePortal, viewProjection);
+  glDepthRange(0.0, 1.0);
+  glDepthFunc(GL_LESS);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+  // Destination view, clipped at the destination portal and limited to the mark
+  auto portalCamera = createPortalCamera(camera, sourcePortal, destPortal);
+  portalCamera->setScreenRect(rect);
+  uint64_t view = portalViewKey(parentView, sourcePortal);
+  scene->render(portalCamera, view);
+
+  // Portals seen through this one take the next stencil value
+  for (auto& portalPair : portalPairs_) {
+    if (!portalPair->isEnabled()) {
+      continue;
+    }
+    for (auto& inner : {portalPair->getPortalA(), portalPair->getPortalB()}) {
+      auto linked = inner == portalPair->getPortalA() ? portalPair->getPortalB() : portalPair->getPortalA();
+      glm::vec4 innerRect;
+      if (!inner || !linked || inner == destPortal || !inner->isEnabled() || !inner->isVisible() ||
+          !isPortalVisible(inner, portalCamera) || !portalScreenRect(inner, portalCamera, rect, innerRect)) {
+        continue;
+      }
+      glStencilFunc(GL_EQUAL, level + 1, 0xFF);
+      renderStencilView(inner, linked, scene, portalCamera, innerRect, target, level + 1, view);
+    }
+  }
+  glScissor(scissor.x, scissor.y, scissor.z, scissor.w);
+
+  // Put the portal's own depth back and return its pixels to the parent level
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+  glDepthMask(GL_TRUE);
+  glDepthFunc(GL_ALWAYS);
+  glStencilFunc(GL_EQUAL, level + 1, 0xFF);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_DECR);
+  drawPortalMask(sourcePortal, viewProjection);
+  glDepthFunc(GL_LESS);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  glStencilFunc(GL_EQUAL, level, 0xFF);
+  glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+  if (markQuery) {
+    glEndConditionalRender();
+  }
+}
+
+void PortalRenderer::drawPortalMask(std::shared_ptr<Portal> portal, const glm::mat4& viewProjection) {
+  if (!maskShader_) {
+    maskShader_ = Shader::fromString(3, 3,
+        "#version 330 core\n"
+        "layout (location = 0) in vec3 aPos;\n"
+        "uniform mat4 model;\n"
+        "uniform mat4 viewProjection;\n"
+        "void main() { gl_Position = viewProjection * model * vec4(aPos, 1.0); }\n",
+        "#version 330 core\n"
+        "void main() {}\n");
+  }
+
+  auto surface = portalSurface(portal, maskShader_);
+  if (!surface) {
+    return;
   }
 
-  // Unbind framebuffer
-  framebuffer->unbind();
+  maskShader_->use();
+  maskShader_->set(maskShader_->uniform("model"), surface->getModel());
+  maskShader_->set(maskShader_->uniform("viewProjection"), viewProjection);
+  GLState::bindVertexArray(surface->getVAO());
+  glDrawElements(GL_TRIANGLES, surface->getCount(), GL_UNSIGNED_INT, 0);
+}
+
+std::shared_ptr<Object> PortalRenderer::portalSurface(std::shared_ptr<Portal> portal,
+                                                      std::shared_ptr<Shader> shader) {
+  auto it = portalSurfaces_.find(portal);
+  if (it != portalSurfaces_.end()) {
+    return it->second;
+  }
+
+  auto surface = PortalSurface::createSurface(portal, shader);
+  if (surface) {
+    portalSurfaces_[portal] = surface;
+  }
+  return surface;
+}
+
+PortalRenderer::PortalView PortalRenderer::renderPortalView(std::shared_ptr<Portal> sourcePortal,
+                                                            std::shared_ptr<Portal> destPortal,
+                                                            std::shared_ptr<Scene> scene,
+                                                            std::shared_ptr<Camera> playerCamera,
+                                                            const glm::vec4& rect,
+                                                            int recursionDepth,
+                                                            uint64_t parentView,
+                                                            unsigned int condition) {
+  if (!sourcePortal || !destPortal || !scene || !playerCamera) {
+    return {};
+  }
+
+  // Prevent infinite recursion
+  if (recursionDepth >= maxRecursionDepth_) {
+    return {};
+  }
+
+  // Only the portal's rectangle is rendered, stretched over the whole target,
+  // and only what is visible through it is drawn
+  auto portalCamera = createPortalCamera(playerCamera, sourcePortal, destPortal);
+  portalCamera->setScreenRect(rect, true);
+  uint64_t viewKey = portalViewKey(parentView, sourcePortal);
+
+  // Portals visible in this view are rendered first, their targets go back
+  // to the pool once this view is complete
+  std::vector<std::pair<std::shared_ptr<Portal>, PortalView>> innerViews;
+  bool cameraInFront = destPortal->isPointInFront(portalCamera->position());
+  for (auto& portalPair : portalPairs_) {
+    // This view and its parents are counted once their inner views are done
+    if (!portalPair->isEnabled() || recursionDepth + 1 >= maxRecursionDepth_ ||
+        !withinBudget(recursionDepth + 1)) {
+      continue;
+    }
+
+    auto portalA = portalPair->getPortalA();
+    auto portalB = portalPair->getPortalB();
+    for (auto& inner : {portalA, portalB}) {
+      auto linked = inner == portalA ? portalB : portalA;
+      // Only portals beyond the destination portal can show up in this view
+      glm::vec4 innerRect;
+      if (!inner || !linked || inner == destPortal || !inner->isEnabled() || !inner->isVisible() ||
+          destPortal->isPointInFront(inner->getPosition()) == cameraInFront ||
+          !isPortalVisible(inner, portalCamera) || !portalScreenRect(inner, portalCamera, rect, innerRect)) {
+        continue;
+      }
+
+      auto innerView = renderPortalView(inner, linked, scene, portalCamera, innerRect, recursionDepth + 1,
+                                        viewKey, condition);
+      if (innerView.framebuffer) {
+        innerViews.emplace_back(inner, innerView);
+      }
+    }
+  }
+
+  // Target sized to the portal's pixels on screen, up to the configured size
+  PortalView view;
+  glm::ivec4 footprint = pixelRect(rect, screenViewport_);
+  view.size = glm::clamp(glm::ivec2(footprint.z, footprint.w), glm::ivec2(1), framebufferSize_);
+  view.rect = rect;
+  view.viewProjection = playerCamera->screenProjection() * playerCamera->viewMatrix();
+  // Outermost views may be reused in later frames
+  view.framebuffer = framebufferPool_.acquire(view.size, recursionDepth == 0);
+  viewsRendered_++;
+
+  if (view.framebuffer->isComplete()) {
+    // Bind portal framebuffer, the pooled target may be larger than needed
+    view.framebuffer->bind();
+    glm::ivec4 target(0, 0, view.size.x, view.size.y);
+    glViewport(target.x, target.y, target.z, target.w);
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(target.x, target.y, target.z, target.w);
+    view.framebuffer->clear(0.2f, 0.5f, 0.8f, 1.0f);  // Blue-green background
+
+    // Conditional rendering does not nest, inner views close theirs before this one opens
+    if (condition) {
+      glBeginConditionalRender(condition, GL_QUERY_NO_WAIT);
+    }
+
+    // Ensure we're rendering to the framebuffer
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR) {
+      std::cerr << "[Portal] GL Error before scene render: " << err << std::endl;
+    }
+
+    scene->render(portalCamera, viewKey);
+
+    // The frame block still holds this view, inner surfaces are drawn with it
+    for (auto& [inner, innerView] : innerViews) {
+      renderPortalSurface(inner, portalCamera, nullptr, innerView);
+    }
+    if (condition) {
+      glEndConditionalRender();
+    }
+    glDisable(GL_SCISSOR_TEST);
+
+    // Check for errors after rendering
+    err = glGetError();
+    if (err != GL_NO_ERROR) {
+      std::cerr << "[Portal] GL Error after scene render: " << err << std::endl;
+    }
+
+    // Unbind framebuffer
+    view.framebuffer->unbind();
+  } else {
+    framebufferPool_.release(view.framebuffer);
+    view = PortalView();
+  }
+
+  for (auto& [inner, innerView] : innerViews) {
+    framebufferPool_.release(innerView.framebuffer);
+  }
+  return view;
+}
+
+std::shared_ptr<PortalViewCamera> PortalRenderer::createPortalCamera(std::shared_ptr<Camera> camera,
+                                                                    std::shared_ptr<Portal> sourcePortal,
+                                                                    std::shared_ptr<Portal> destPortal) {
+  glm::vec4 clippingPlane;
+  glm::mat4 portalView = PortalCamera::calculatePortalViewWithClipping(
+      *camera, *sourcePortal, *destPortal, clippingPlane);
+  auto portalCamera = std::make_shared<PortalViewCamera>(camera, portalView);
+
+  // Same projection as the camera looking in, the view lines up with the screen
+  glm::mat4 projection = portalCamera->unclippedProjection();
+
+  // Geometry between the virtual camera and the destination portal would
+  // only be overdrawn, the oblique near plane clips it
+  portalCamera->setProjection(projection,
+                              PortalCamera::obliqueProjection(projection, portalView, clippingPlane));
+  return portalCamera;
 }
 
 void PortalRenderer::renderPortalSurface(std::shared_ptr<Portal> portal,
                                         std::shared_ptr<Camera> playerCamera,
-                                        std::shared_ptr<Shader> portalShader) {
+                                        std::shared_ptr<Shader> portalShader,
+                                        const PortalView& view) {
   if (!portal || !playerCamera) {
     return;
   }
 
-  auto framebuffer = portal->getFramebuffer();
+  auto framebuffer = view.framebuffer;
   if (!framebuffer || !framebuffer->isComplete()) {
     return;
   }
@@ -260,20 +669,7 @@ void PortalRenderer::renderPortalSurface(std::shared_ptr<Portal> portal,
   }
 
   // Get or create portal surface object
-  std::shared_ptr<Object> portalSurface;
-  auto it = portalSurfaces_.find(portal);
-  if (it == portalSurfaces_.end()) {
-    // Create portal surface mesh
-    portalSurface = PortalSurface::createSurface(portal, portalShader);
-    if (portalSurface) {
-      portalSurfaces_[portal] = portalSurface;
-    } else {
-      return;
-    }
-  } else {
-    portalSurface = it->second;
-  }
-
+  auto portalSurface = this->portalSurface(portal, portalShader);
   if (!portalSurface) {
     return;
   }
@@ -340,38 +736,25 @@ void PortalRenderer::renderPortalSurface(std::shared_ptr<Portal> portal,
   }
   
   // Then bind texture and set uniform
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, textureId);
-  GLint texLoc = glGetUniformLocation(currentProgram, "portalTexture");
-  if (texLoc >= 0) {
-    glUniform1i(texLoc, 0);
-  } else {
-    std::cerr << "[Portal] WARNING: portalTexture uniform not found in shader!" << std::endl;
-  }
-  
-  // Set matrices directly (bypass setMat4fv which calls unuse)
-  glm::mat4 projection = playerCamera->projectionMatrix();
-  glm::mat4 view = playerCamera->viewMatrix();
-  glm::mat4 model = portalSurface->getModel();
-  
-  GLint projLoc = glGetUniformLocation(currentProgram, "projection");
-  GLint viewLoc = glGetUniformLocation(currentProgram, "view");
-  GLint modelLoc = glGetUniformLocation(currentProgram, "model");
-  
-  if (projLoc >= 0) {
-    glUniformMatrix4fv(projLoc, 1, GL_FALSE, &projection[0][0]);
-  } else {
-    std::cerr << "[Portal] WARNING: projection uniform not found!" << std::endl;
+  GLState::bindTexture(0, GL_TEXTURE_2D, textureId);
+  portalShader->set(portalShader->uniform("portalTexture"), 0);
+  portalShader->set(portalShader->uniform("portalViewProjection"), view.viewProjection);
+  portalShader->set(portalShader->uniform("portalRect"), view.rect);
+  portalShader->set(portalShader->uniform("portalScale"),
+                    glm::vec2(view.size) / glm::vec2(framebuffer->getWidth(), framebuffer->getHeight()));
+
+  // Camera matrices come from the FrameData block, a legacy portal program
+  // declaring its own projection/view still gets them uploaded here
+  auto& uniforms = portalShader->objectUniforms();
+  if (!uniforms.model.valid()) {
+    std::cerr << "[Portal] WARNING: model uniform not found!" << std::endl;
   }
-  if (viewLoc >= 0) {
-    glUniformMatrix4fv(viewLoc, 1, GL_FALSE, &view[0][0]);
-  } else {
-    std::cerr << "[Portal] WARNING: view uniform not found!" << std::endl;
+  portalShader->set(uniforms.model, portalSurface->getModel());
+  if (uniforms.projection.valid()) {
+    portalShader->set(uniforms.projection, playerCamera->projectionMatrix());
   }
-  if (modelLoc >= 0) {
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, &model[0][0]);
-  } else {
-    std::cerr << "[Portal] WARNING: model uniform not found!" << std::endl;
+  if (uniforms.view.valid()) {
+    portalShader->set(uniforms.view, playerCamera->viewMatrix());
   }
   
   // Check for GL errors after setting uniforms
@@ -386,13 +769,13 @@ void PortalRenderer::renderPortalSurface(std::shared_ptr<Portal> portal,
   glDepthMask(GL_TRUE);
   
   // Render the portal quad
-  glBindVertexArray(vao);
+  GLState::bindVertexArray(vao);
   
   // Check for GL errors after binding VAO
   err = glGetError();
   if (err != GL_NO_ERROR) {
     std::cerr << "[Portal] GL Error after binding VAO: " << err << std::endl;
-    glBindVertexArray(0);
+    GLState::bindVertexArray(0);
     return;
   }
   
@@ -401,7 +784,7 @@ void PortalRenderer::renderPortalSurface(std::shared_ptr<Portal> portal,
   } else {
     glDrawArrays(GL_TRIANGLES, 0, count);
   }
-  glBindVertexArray(0);
+  GLState::bindVertexArray(0);
   
   // Check for GL errors after rendering
   err = glGetError();
@@ -414,7 +797,7 @@ void PortalRenderer::renderPortalSurface(std::shared_ptr<Portal> portal,
   glDepthMask(GL_TRUE);
   
   // Unbind texture
-  glBindTexture(GL_TEXTURE_2D, 0);
+  GLState::bindTexture(0, GL_TEXTURE_2D, 0);
 }
 
 bool PortalRenderer::isPortalVisible(std::shared_ptr<Portal> portal,
@@ -425,6 +808,75 @@ bool PortalRenderer::isPortalVisible(std::shared_ptr<Portal> portal,
 
   // Simple visibility check: is camera in front of portal?
   glm::vec3 cameraPos = camera->position();
-  return portal->isPointInFront(cameraPos);
+  if (!portal->isPointInFront(cameraPos)) {
+    return false;
+  }
+
+  // Outside the frustum when all corners are behind one of its planes
+  glm::vec3 corners[4];
+  portal->getCorners(corners);
+  for (auto& plane : camera->frustum()) {
+    int behind = 0;
+    for (auto& corner : corners) {
+      behind += plane.distTPlane(Point3<float>(corner.x, corner.y, corner.z)) < 0;
+    }
+    if (behind == 4) {
+      return false;
+    }
+  }
+  return true;
 }
 
+bool PortalRenderer::portalScreenRect(std::shared_ptr<Portal> portal,
+                                      std::shared_ptr<Camera> camera,
+                                      const glm::vec4& bounds,
+                                      glm::vec4& rect) const {
+  glm::vec3 corners[4];
+  portal->getCorners(corners);
+  // Rectangles are in screen space, also for views rendered stretched over their target
+  glm::mat4 viewProjection = camera->screenProjection() * camera->viewMatrix();
+
+  // Culled when every corner is outside the same clip plane
+  int outside[6] = {0, 0, 0, 0, 0, 0};
+  bool behind = false;
+  glm::vec2 low(1.0f);
+  glm::vec2 high(0.0f);
+  for (auto& corner : corners) {
+    glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+    outside[0] += clip.x < -clip.w;
+    outside[1] += clip.x > clip.w;
+    outside[2] += clip.y < -clip.w;
+    outside[3] += clip.y > clip.w;
+    outside[4] += clip.z < -clip.w;
+    outside[5] += clip.z > clip.w;
+    if (clip.w <= 1e-5f) {
+      behind = true;
+      continue;
+    }
+    glm::vec2 screen = glm::vec2(clip) / clip.w * 0.5f + 0.5f;
+    low = glm::min(low, screen);
+    high = glm::max(high, screen);
+  }
+  for (int plane : outside) {
+    if (plane == 4) {
+      return false;
+    }
+  }
+
+  // A corner behind the camera has no screen position, keep the whole bounds
+  if (behind) {
+    rect = bounds;
+    return true;
+  }
+  rect = glm::vec4(glm::max(glm::vec2(bounds), low), glm::min(glm::vec2(bounds.z, bounds.w), high));
+  return rect.x < rect.z && rect.y < rect.w;
+}
+
+glm::ivec4 PortalRenderer::pixelRect(const glm::vec4& rect, const glm::ivec4& target) {
+  // Rounded outwards so partially covered pixels are kept
+  int x0 = target.x + static_cast<int>(std::floor(rect.x * target.z));
+  int y0 = target.y + static_cast<int>(std::floor(rect.y * target.w));
+  int x1 = target.x + static_cast<int>(std::ceil(rect.z * target.z));
+  int y1 = target.y + static_cast<int>(std::ceil(rect.w * target.w));
+  return glm::ivec4(x0, y0, x1 - x0, y1 - y0);
+}
@@ -2,6 +2,7 @@
 #include <geometry/Portal.h>
 #include <geometry/Object.h>
 #include <geometry/Vertex.h>
+#include <render/GLState.h>
 #include <render/Shader.h>
 #include <glad/glad.h>
 
@@ -31,7 +32,7 @@ std::shared_ptr<Object> PortalSurface::createSurface(
   glGenBuffers(1, &VBO);
   glGenBuffers(1, &EBO);
 
-  glBindVertexArray(VAO);
+  GLState::bindVertexArray(VAO);
 
   // Upload vertex data
   glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -59,7 +60,7 @@ std::shared_ptr<Object> PortalSurface::createSurface(
   glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
                        (void*)offsetof(Vertex, uv));
 
-  glBindVertexArray(0);
+  GLState::bindVertexArray(0);
 
   // Create Object with EBO
   // Note: Object constructor takes (VAO, VBO, count, type)
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 #include <geometry/Scene.h>
 #include <geometry/PortalRenderer.h>
@@ -10,6 +13,7 @@
 #include <system/TextureManager.h>
 #include <utils/Loader.h>
 #include <render/Camera.h>
+#include <render/GLState.h>
 
 using namespace std;
 using namespace omega::render;
@@ -32,8 +36,8 @@ Scene::Scene(std::string const &path, bool gamma) : gammaCorrection(gamma) {
   loadModel(path);
 }
 
-auto Scene::import(std::string const &path) -> void {
-loadModel(path);
+auto Scene::import(std::string const &path, unsigned int flags) -> void {
+loadModel(path, flags);
 if(meshShader_ && lightShader_)
 shaders(meshShader_, lightShader_);
 }
@@ -50,10 +54,11 @@ auto Scene::add(std::shared_ptr<Object> object) -> void
 	_root = std::make_shared<ObjectNode>();
 
   _root->meshes.push_back(object);
+  tablesDirty_ = true;
 }
 
-void Scene::loadModel(string const &path) {
-  auto tree = Loader::loadModel(path);
+void Scene::loadModel(string const &path, unsigned int flags) {
+  auto tree = Loader::loadModel(path, flags);
 
   add(tree);
 }
@@ -64,50 +69,165 @@ auto Scene::add(std::shared_ptr<ObjectNode> tree) ->void
 	_root = std::make_shared<ObjectNode>();
 
   _root->children.push_back(tree);
+  tablesDirty_ = true;
 }
 
-auto Scene::prepare() -> void {
-  prepare(_root);
+auto Scene::compile() -> void {
+  // The tree structure changed, start from fully propagated transforms
+  if (_root)
+	_root->updateTransforms(glm::mat4(1.0f), true);
+
+  tables_.compile(_root);
+  for (auto &[view, state] : views_)
+	state.lods.clear();
+
+  std::vector<uint32_t> staticSlots;
+  std::vector<uint32_t> dynamicSlots;
+  unbounded_.clear();
+  for (uint32_t slot = 0; slot < tables_.size(); slot++) {
+	auto flags = tables_.flags[slot];
+	if (!(flags & SceneTables::BOUNDED))
+	  unbounded_.push_back(slot);
+	else if (flags & SceneTables::DYNAMIC)
+	  dynamicSlots.push_back(slot);
+	else
+	  staticSlots.push_back(slot);
+  }
+
+  if (staticBatching_ || gpuCulling_) {
+	std::vector<uint32_t> batchable;
+	for (auto slot : staticSlots) {
+	  if (instanceable(slot) && !(tables_.flags[slot] & SceneTables::TRANSLUCENT))
+		batchable.push_back(slot);
+	}
+	if (!staticBatch_)
+	  staticBatch_ = std::make_unique<StaticBatch>();
+	staticBatch_->gpuCulling(gpuCulling_);
+	staticBatch_->build(tables_, batchable);
+  } else {
+	staticBatch_.reset();
+  }
+
+  staticHierarchy_.build(tables_.bounds, std::move(staticSlots));
+  dynamicHierarchy_.build(tables_.bounds, std::move(dynamicSlots));
+  tablesDirty_ = false;
 }
 
-auto Scene::prepare(ObjectNodePtr node) -> void {
-  if (node == nullptr)
-	return;
+auto Scene::updateTransforms() -> void {
+  if (tablesDirty_)
+	compile();
+
+  if (_root)
+	_root->updateTransforms(glm::mat4(1.0f), false);
+
+  if (tables_.staticMoved) {
+	staticHierarchy_.refit();
+	if (staticBatch_)
+	  staticBatch_->refresh(tables_);
+	tables_.staticMoved = false;
+  }
+}
+
+auto Scene::prepare() -> void {
+  if (tablesDirty_)
+	compile();
 
-  for (auto object : node->meshes) {
+  for (auto &object : tables_.objects) {
 	object->affectedByLights(lights_);
 	object->setupPhysics(physics_world_, &physics_common_);
   }
 
-  for (auto child : node->children)
-	prepare(child);
+  // Bodies now exist, slots may have moved to the dynamic hierarchy
+  tablesDirty_ = true;
 }
 
 void Scene::render() {
   auto camera = cameras_[current_camera_];
+  frame_++;
   
+  bool portals = portalRenderer_ && portalRenderer_->isEnabled();
+  bool stencilPortals = portals && portalRenderer_->getMode() == PortalRenderer::Mode::Stencil;
+
   // Render portal views first (to framebuffers) - BEFORE main scene
   // Note: We pass 'this' as shared_ptr - caller must ensure Scene is managed by shared_ptr
-  if (portalRenderer_ && portalRenderer_->isEnabled()) {
-    // Create temporary shared_ptr for portal rendering
-    // In practice, Scene should be managed by shared_ptr from the start
-    std::shared_ptr<Scene> scenePtr(this, [](Scene*){});  // Non-owning shared_ptr
+  // In practice, Scene should be managed by shared_ptr from the start
+  std::shared_ptr<Scene> scenePtr(this, [](Scene*){});  // Non-owning shared_ptr
+  if (portals && !stencilPortals) {
     portalRenderer_->renderPortals(scenePtr, camera, meshShader_);
   }
   
   // Render main scene
   this->render(camera);
   
-  // Render portal surfaces AFTER main scene so they appear on top
+  // Stencil portals draw their views straight into the main scene's pixels,
+  // texture portals render their surfaces AFTER main scene so they appear on top
   // Pass nullptr to let PortalRenderer create/use the portal shader
-  if (portalRenderer_ && portalRenderer_->isEnabled()) {
+  if (stencilPortals) {
+    portalRenderer_->renderStencilPortals(scenePtr, camera);
+  } else if (portals) {
     portalRenderer_->renderPortalSurfaces(camera, nullptr);
   }
+
+  // Portals out of sight for a while give up their view state
+  for (auto it = views_.begin(); it != views_.end();) {
+	if (frame_ - it->second.lastFrame > VIEW_IDLE_FRAMES) {
+	  if (staticBatch_)
+		staticBatch_->forgetView(it->first);
+	  it = views_.erase(it);
+	} else {
+	  ++it;
+	}
+  }
 }
 
 // draws the model, and thus all its meshes
-void Scene::render(std::shared_ptr<render::Camera> camera) {
-  render(_root, camera);
+void Scene::render(std::shared_ptr<render::Camera> camera, uint64_t view) {
+  view_ = view;
+  if (!frameData_)
+	frameData_ = std::make_unique<FrameData>();
+  frameData_->update(*camera, time_, ambient_);
+
+  if (!lightClusters_)
+	lightClusters_ = std::make_unique<LightClusters>();
+  // Lights are only repacked when the list changed or one of them moved
+  if (!lightsDirty_)
+	lightsDirty_ = std::any_of(lights_.begin(), lights_.end(), [](auto &light) { return light->changed(); });
+  if (lightsDirty_) {
+	lightClusters_->updateLights(lights_);
+	lightsDirty_ = false;
+  }
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  lightClusters_->build(*camera, glm::ivec4(viewport[0], viewport[1], viewport[2], viewport[3]));
+
+  updateTransforms();
+
+  visible_.clear();
+  auto &frustum = camera->frustum();
+  staticHierarchy_.cull(frustum, visible_);
+  dynamicHierarchy_.cull(frustum, visible_);
+  if (occlusionCulling_)
+	cullOccluded(camera);
+  selectLods(camera);
+
+  // Nothing is known about state left behind by code outside the queue
+  GLState::invalidate();
+  if (staticBatch_)
+	staticBatch_->prepare(tables_, visible_, *lods_, camera, view_);
+  enqueue(camera);
+  batch();
+  if (deferred_) {
+	shadeDeferred(camera, glm::ivec4(viewport[0], viewport[1], viewport[2], viewport[3]));
+  } else {
+	if (depthPrepass_)
+	  prepass(camera);
+	submit(camera, RenderQueue::SOLID, RenderQueue::BLENDED);
+  }
+  GLState::bindVertexArray(0);
+
+  // Opaque geometry is down, keep its depth for next frame's GPU occlusion test
+  if (staticBatch_)
+	staticBatch_->captureDepth(*camera, view_, glm::ivec4(viewport[0], viewport[1], viewport[2], viewport[3]));
 
   for (auto light : lights_)
 	light->render(camera, lightShader_);
@@ -124,75 +244,338 @@ void Scene::render(std::shared_ptr<render::Camera> camera) {
   }
 }
 
-void Scene::render(ObjectNodePtr node, std::shared_ptr<render::Camera> camera) {
-  if (node == nullptr)
-	return;
+auto Scene::drawsItself(uint32_t slot) const -> bool {
+  // Subclasses and programs that still take per-object lights keep their own path
+  auto *shader = tables_.shaders[slot];
+  return !shader || (tables_.flags[slot] & SceneTables::CUSTOM_RENDER) || !shader->usesClusteredLights();
+}
+
+auto Scene::instanceable(uint32_t slot) const -> bool {
+  return !drawsItself(slot) && tables_.shaders[slot]->supportsInstancing();
+}
+
+auto Scene::sameDraw(uint32_t a, uint32_t b) const -> bool {
+  auto first = tables_.lodDraw(a, (*lods_)[a]);
+  auto second = tables_.lodDraw(b, (*lods_)[b]);
+  return tables_.shaders[a]==tables_.shaders[b] && tables_.textureSets[a]==tables_.textureSets[b] &&
+	  first.vao==second.vao && first.first==second.first && first.count==second.count && first.type==second.type;
+}
+
+auto Scene::cullOccluded(const std::shared_ptr<render::Camera> &camera) -> void {
+  if (!occlusion_) {
+	workers_ = std::make_unique<WorkerPool>();
+	occlusion_ = std::make_unique<OcclusionBuffer>(workers_.get());
+  }
 
-  for (auto object : node->meshes) {
-	object->render(camera);
+  occlusion_->begin(camera->projectionMatrix() * camera->viewMatrix());
+  for (auto slot : visible_) {
+	if ((tables_.flags[slot] & (SceneTables::OCCLUDER | SceneTables::VISIBLE))==
+		(SceneTables::OCCLUDER | SceneTables::VISIBLE))
+	  occlusion_->addOccluder(*tables_.objects[slot]->occluder(), tables_.world[slot]);
   }
+  if (occlusion_->triangleCount()==0)
+	return;
+  occlusion_->rasterize();
 
-  for (auto child : node->children)
-	render(child, camera);
+  // Occluders are drawn regardless, testing them against themselves gains nothing
+  std::erase_if(visible_, [this](uint32_t slot) {
+	return !(tables_.flags[slot] & SceneTables::OCCLUDER) && !occlusion_->visible(tables_.bounds[slot]);
+  });
 }
 
-// draws the model, and thus all its meshes
-void Scene::shaders(std::shared_ptr<render::Shader> shader,
-					std::shared_ptr<render::Shader> lightShader) {
-  shaders(shader, _root);
+auto Scene::selectLods(const std::shared_ptr<render::Camera> &camera) -> void {
+  auto &state = views_[view_];
+  state.lastFrame = frame_;
+  lods_ = &state.lods;
+  lods_->resize(tables_.size(), 0);
+
+  // Bounding sphere radius over distance, scaled to half viewport heights
+  float scale = camera->screenProjection()[1][1];
+  glm::vec3 eye = glm::vec3(glm::inverse(camera->viewMatrix())[3]);
+  for (auto slot : visible_) {
+	int levels = tables_.lodCount(slot);
+	if (levels==1)
+	  continue;
+
+	auto &sphere = tables_.spheres[slot];
+	float distance = glm::length(glm::vec3(sphere.center.x, sphere.center.y, sphere.center.z) - eye);
+	float size = distance > sphere.radius ? sphere.radius * scale / distance : INFINITY;
+	(*lods_)[slot] = static_cast<uint8_t>(selectLod(size, (*lods_)[slot], levels));
+  }
+}
 
-  meshShader_ = shader;
-  lightShader_ = lightShader;
+auto Scene::enqueue(const std::shared_ptr<render::Camera> &camera) -> void {
+  queue_.clear();
+  glm::mat4 view = camera->viewMatrix();
+  float farPlane = camera->farPlane();
+
+  for (auto &slots : {std::cref(visible_), std::cref(unbounded_)}) {
+	for (auto slot : slots.get()) {
+	  auto flags = tables_.flags[slot];
+	  if (!(flags & SceneTables::VISIBLE) || (staticBatch_ && staticBatch_->covers(tables_, slot)))
+		continue;
+
+	  glm::vec3 center = glm::vec3(tables_.world[slot][3]);
+	  if (flags & SceneTables::BOUNDED) {
+		auto &sphere = tables_.spheres[slot];
+		center = glm::vec3(sphere.center.x, sphere.center.y, sphere.center.z);
+	  }
+	  float depth = -(view * glm::vec4(center, 1.0f)).z / farPlane;
+
+	  // Classified by material, the sky goes after everything opaque
+	  auto *shader = tables_.shaders[slot];
+	  auto pass = RenderQueue::SOLID;
+	  if (flags & SceneTables::SKY)
+		pass = RenderQueue::SKY;
+	  else if (flags & SceneTables::TRANSLUCENT)
+		pass = RenderQueue::BLENDED;
+	  else if (drawsItself(slot))
+		pass = RenderQueue::CUSTOM;
+	  queue_.push(RenderQueue::key(pass, shader ? shader->programId() : 0, tables_.textureSets[slot],
+								   tables_.draws[slot].vao, (*lods_)[slot], depth), slot);
+	}
+  }
+
+  queue_.sort();
 }
 
-void Scene::shaders(std::shared_ptr<render::Shader> shader, ObjectNodePtr node) {
-  if (node == nullptr)
-	return;
+auto Scene::batch() -> void {
+  if (!instances_)
+	instances_ = std::make_unique<InstanceBuffer>();
+  instances_->clear();
+  batches_.clear();
+
+  // Sorting put equal programs, meshes and texture sets next to each other
+  auto &items = queue_.items();
+  for (size_t first = 0; first < items.size();) {
+	auto slot = items[first].index;
+	auto pass = RenderQueue::pass(items[first].key);
+	size_t last = first + 1;
+	if (!instanceable(slot) || pass==RenderQueue::BLENDED) {
+	  batches_.push_back({slot, 0, 1, false, pass});
+	  first = last;
+	  continue;
+	}
 
-  for (auto object : node->meshes) {
-	object->setShader(shader);
+	while (last < items.size() && instanceable(items[last].index) && sameDraw(slot, items[last].index))
+	  last++;
+
+	batches_.push_back({slot, instances_->size(), static_cast<unsigned int>(last - first), true, pass});
+	for (size_t i = first; i < last; i++)
+	  instances_->push(tables_.world[items[i].index], tables_.shininess(items[i].index));
+	first = last;
   }
+  if (instances_->size())
+	instances_->upload();
+}
 
-  for (auto child : node->children)
-	shaders(shader, child);
+auto Scene::prepass(std::shared_ptr<render::Camera> &camera) -> void {
+  if (!depthShader_)
+	depthShader_ = Shader::fromFile(3, 3, ":/shaders/depth.vs", ":/shaders/depth.fs");
+
+  // Instanced opaque batches share core.vs' vertex transform, everything else
+  // keeps its own program and is depth tested as usual later on
+  glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+  if (staticBatch_)
+	staticBatch_->draw(tables_, camera, depthShader_.get(), false);
+
+  auto *shader = depthShader_.get();
+  auto &uniforms = shader->objectUniforms();
+  shader->use();
+  shader->set(uniforms.instanced, 1);
+  for (auto &batch : batches_) {
+	if (batch.pass!=RenderQueue::SOLID || !batch.instanced)
+	  continue;
+	shader->set(uniforms.instanceBase, static_cast<int>(batch.first));
+	tables_.lodDraw(batch.slot, (*lods_)[batch.slot]).drawInstanced(batch.count);
+  }
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 }
 
-void Scene::lights(std::vector<std::shared_ptr<Light>> light_list) {
-  lights_ = light_list;
+auto Scene::shadeDeferred(std::shared_ptr<render::Camera> &camera, const glm::ivec4 &viewport) -> void {
+  if (!gbufferShader_)
+	gbufferShader_ = Shader::fromFile(3, 3, ":/shaders/core.vs", ":/shaders/gbuffer.fs");
+  auto &state = views_[view_];
+  if (!state.gbuffer)
+	state.gbuffer = std::make_unique<GBuffer>();
+  auto &gbuffer = *state.gbuffer;
 
-  lights(light_list, _root);
+  // Opaque slots all use clustered lighting programs, the G-buffer program stands in for them
+  gbuffer.begin(viewport);
+  if (depthPrepass_)
+	prepass(camera);
+  submit(camera, RenderQueue::SOLID, RenderQueue::SOLID, gbufferShader_.get());
+
+  gbuffer.resolve(*camera);
+
+  submit(camera, RenderQueue::CUSTOM, RenderQueue::BLENDED);
 }
 
-void Scene::lights(std::vector<std::shared_ptr<Light>> light_list, ObjectNodePtr node) {
-  if (node == nullptr)
-	return;
+auto Scene::submit(std::shared_ptr<render::Camera> &camera, uint32_t first, uint32_t last, Shader *program) -> void {
+  // Pre-passed draws only shade the fragments that won the depth test
+  bool depthEqual = depthPrepass_ && first==RenderQueue::SOLID;
+  bool depthWrite = !depthEqual;
+  if (depthEqual) {
+	glDepthFunc(GL_EQUAL);
+	glDepthMask(GL_FALSE);
+  }
+  if (staticBatch_ && first==RenderQueue::SOLID)
+	staticBatch_->draw(tables_, camera, program);
+
+  // Only rebind what differs from the previous batch
+  const uint32_t NONE = ~0u;
+  Shader *boundShader = nullptr;
+  uint32_t boundTextures = NONE;
+  for (auto &batch : batches_) {
+	if (batch.pass < first || batch.pass > last)
+	  continue;
+	auto slot = batch.slot;
+	bool blended = batch.pass==RenderQueue::BLENDED;
+	bool equal = depthPrepass_ && batch.pass==RenderQueue::SOLID && batch.instanced;
+	if (equal!=depthEqual || (!equal && !blended)!=depthWrite) {
+	  depthEqual = equal;
+	  depthWrite = !equal && !blended;
+	  glDepthFunc(depthEqual ? GL_EQUAL : GL_LESS);
+	  glDepthMask(depthWrite ? GL_TRUE : GL_FALSE);
+	}
+	if (blended)
+	  glEnable(GL_BLEND);
+
+	if (drawsItself(slot)) {
+	  tables_.objects[slot]->render(camera);
+	  boundShader = nullptr;
+	  boundTextures = NONE;
+	  continue;
+	}
 
-  for (auto object : node->meshes) {
-	object->affectedByLights(light_list);
+	auto *shader = program ? program : tables_.shaders[slot];
+	auto &uniforms = shader->objectUniforms();
+	if (shader!=boundShader) {
+	  shader->use();
+	  if (uniforms.projection.valid())
+		shader->set(uniforms.projection, camera->projectionMatrix());
+	  if (uniforms.view.valid())
+		shader->set(uniforms.view, camera->viewMatrix());
+	  if (uniforms.viewPos.valid())
+		shader->set(uniforms.viewPos, camera->position());
+	  boundShader = shader;
+	}
+
+	if (tables_.textureSets[slot]!=boundTextures) {
+	  boundTextures = tables_.textureSets[slot];
+	  auto &textures = tables_.textureSetTable[boundTextures];
+	  for (int no = 0; no < textures.size(); no++)
+		textures[no]->activate(no);
+	}
+
+	shader->set(uniforms.compactNormals, (tables_.flags[slot] & SceneTables::COMPACT) ? 1 : 0);
+	if (batch.instanced) {
+	  // Only opaque slots are instanced, clear what the last blended draw left
+	  shader->set(uniforms.instanced, 1);
+	  shader->set(uniforms.transparency, 0.0f);
+	  shader->set(uniforms.instanceBase, static_cast<int>(batch.first));
+	  tables_.lodDraw(slot, (*lods_)[slot]).drawInstanced(batch.count);
+	  continue;
+	}
+
+	shader->set(uniforms.instanced, 0);
+	shader->set(uniforms.model, tables_.world[slot]);
+	auto material = tables_.materials[slot];
+	float opacity = 1.0f;
+	if (material!=SceneTables::NO_MATERIAL) {
+	  shader->set(uniforms.shininess, tables_.materialTable[material].shininess);
+	  opacity = tables_.materialTable[material].opacity;
+	}
+	shader->set(uniforms.transparency, 1.0f - opacity);
+	tables_.lodDraw(slot, (*lods_)[slot]).draw();
   }
 
-  for (auto child : node->children)
-	lights(light_list, child);
+  // Leave the defaults behind for lights and whatever draws after the scene
+  glDisable(GL_BLEND);
+  glDepthFunc(GL_LESS);
+  glDepthMask(GL_TRUE);
 }
 
-// function to find an object by name and return it
-auto Scene::object(std::string name) -> std::shared_ptr<Object> {
-  return object( name, _root);
-}
+auto Scene::pick(const Point3<float> &start, const Point3<float> &end, float *t) -> std::shared_ptr<Object> {
+  if (tablesDirty_)
+	compile();
+
+  float staticT = 1.0f;
+  float dynamicT = 1.0f;
+  auto hit = staticHierarchy_.raycast(start, end, &staticT);
+  auto dynamicHit = dynamicHierarchy_.raycast(start, end, &dynamicT);
+  if (dynamicHit != BVH::NONE && (hit == BVH::NONE || dynamicT < staticT)) {
+	hit = dynamicHit;
+	staticT = dynamicT;
+  }
 
-auto Scene::object(std::string name, ObjectNodePtr node) -> std::shared_ptr<Object> {
-  if (node == nullptr)
+  if (hit == BVH::NONE)
 	return nullptr;
+  if (t)
+	*t = staticT;
+  return tables_.objects[hit];
+}
 
-  for (auto object : node->meshes) {
-	if (object->name()==name)
-	  return object;
-  }
+auto Scene::query(const Sphere<float> &sphere) -> std::vector<std::shared_ptr<Object>> {
+  if (tablesDirty_)
+	compile();
+
+  std::vector<uint32_t> slots;
+  staticHierarchy_.query(sphere, slots);
+  dynamicHierarchy_.query(sphere, slots);
+
+  std::vector<std::shared_ptr<Object>> result;
+  for (auto slot : slots)
+	result.push_back(tables_.objects[slot]);
+  return result;
+}
+
+auto Scene::query(const Box3<float> &box) -> std::vector<std::shared_ptr<Object>> {
+  if (tablesDirty_)
+	compile();
+
+  std::vector<uint32_t> slots;
+  staticHierarchy_.query(box, slots);
+  dynamicHierarchy_.query(box, slots);
+
+  std::vector<std::shared_ptr<Object>> result;
+  for (auto slot : slots)
+	result.push_back(tables_.objects[slot]);
+  return result;
+}
+
+// draws the model, and thus all its meshes
+void Scene::shaders(std::shared_ptr<render::Shader> shader,
+					std::shared_ptr<render::Shader> lightShader) {
+  if (tablesDirty_)
+	compile();
+
+  for (auto &object : tables_.objects)
+	object->setShader(shader);
+
+  meshShader_ = shader;
+  lightShader_ = lightShader;
+}
+
+void Scene::lights(std::vector<std::shared_ptr<Light>> light_list) {
+  lights_ = light_list;
+  lightsDirty_ = true;
+
+  if (tablesDirty_)
+	compile();
 
-  for (auto child : node->children) {
-	auto obj = object(name, child);
-	if (obj)
-	  return obj;
+  for (auto &object : tables_.objects)
+	object->affectedByLights(light_list);
+}
+
+// function to find an object by name and return it
+auto Scene::object(std::string name) -> std::shared_ptr<Object> {
+  if (tablesDirty_)
+	compile();
+
+  for (uint32_t slot = 0; slot < tables_.size(); slot++) {
+	if (tables_.names[slot]==name)
+	  return tables_.objects[slot];
   }
 
   return nullptr;
@@ -215,21 +598,13 @@ auto Scene::process(float deltaTime) -> void {
 
   if (deltaTime==0)
 	deltaTime = 0.000001f;
+  time_ += deltaTime;
   physics_world_->update(deltaTime);
 
-  process(_root);
-}
-
-auto Scene::process(ObjectNodePtr node) -> void {
-  if (node == nullptr)
-	return;
-
-  for (auto object : node->meshes) {
-	object->process();
-  }
-
-  for (auto child : node->children)
-	process(child);
+  updateTransforms();
+  tables_.syncBodies();
+  tables_.processCustom();
+  dynamicHierarchy_.refit();
 }
 
 auto Scene::setCurrentCamera(unsigned int index) -> void {
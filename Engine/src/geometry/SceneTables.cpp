@@ -0,0 +1,197 @@
+#include <geometry/SceneTables.h>
+#include <geometry/SkyBox.h>
+
+#include "glm/ext.hpp"
+
+#include <typeinfo>
+
+using namespace omega::geometry;
+
+SceneTables::~SceneTables() {
+  clear();
+}
+
+auto SceneTables::compile(const ObjectNodePtr &root) -> void {
+  clear();
+  append(root);
+
+  for (uint32_t slot = 0; slot < size(); slot++) {
+	if (flags[slot] & DYNAMIC)
+	  dynamicSlots.push_back(slot);
+	if (flags[slot] & CUSTOM_RENDER)
+	  customSlots.push_back(slot);
+  }
+}
+
+auto SceneTables::append(const ObjectNodePtr &node) -> void {
+  if (node == nullptr)
+	return;
+
+  for (auto &object : node->meshes) {
+	uint32_t slot = size();
+	object->tables_ = this;
+	object->slot_ = slot;
+
+	objects.push_back(object);
+	names.emplace_back();
+	draws.push_back(object->drawParams());
+	world.push_back(object->world_);
+	bounds.push_back(object->world_box_);
+	spheres.push_back(object->world_sphere_);
+	bodies.push_back(object->isDynamic() ? object->body_ : nullptr);
+	flags.push_back(0);
+	materials.push_back(NO_MATERIAL);
+	textureSets.push_back(0);
+	shaders.push_back(nullptr);
+	lodCounts.push_back(static_cast<uint8_t>(1 + object->lods_.size()));
+	lodFirst.push_back(static_cast<uint32_t>(lodRanges.size()));
+	lodRanges.insert(lodRanges.end(), object->lods_.begin(), object->lods_.end());
+
+	if (object->hasBounds())
+	  flags[slot] |= BOUNDED;
+	if (object->isDynamic())
+	  flags[slot] |= DYNAMIC;
+	if (typeid(*object)!=typeid(Object))
+	  flags[slot] |= CUSTOM_RENDER;
+	if (dynamic_cast<SkyBox *>(object.get()))
+	  flags[slot] |= SKY;
+	if (object->meshBuffers().format!=VertexFormat::Full)
+	  flags[slot] |= COMPACT;
+	syncState(slot);
+  }
+
+  for (auto &child : node->children)
+	append(child);
+}
+
+auto SceneTables::clear() -> void {
+  for (auto &object : objects)
+	object->tables_ = nullptr;
+
+  world.clear();
+  bounds.clear();
+  spheres.clear();
+  draws.clear();
+  materials.clear();
+  textureSets.clear();
+  shaders.clear();
+  bodies.clear();
+  flags.clear();
+  dynamicSlots.clear();
+  customSlots.clear();
+  lodCounts.clear();
+  lodFirst.clear();
+  lodRanges.clear();
+  staticMoved = false;
+  names.clear();
+  textureSetTable.clear();
+  objects.clear();
+  materialTable.clear();
+  materialIds_.clear();
+  textureSetIds_.clear();
+}
+
+static auto hashCombine(size_t seed, size_t value) -> size_t {
+  return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+auto SceneTables::MaterialKeyHash::operator()(const MaterialKey &key) const -> size_t {
+  size_t seed = std::hash<float>()(std::get<0>(key));
+  seed = hashCombine(seed, std::hash<float>()(std::get<1>(key)));
+  return hashCombine(seed, std::hash<render::Texture *>()(std::get<2>(key)));
+}
+
+auto SceneTables::TextureSetHash::operator()(const std::vector<render::Texture *> &textures) const -> size_t {
+  size_t seed = textures.size();
+  for (auto *texture : textures)
+	seed = hashCombine(seed, std::hash<render::Texture *>()(texture));
+  return seed;
+}
+
+auto SceneTables::materialId(const render::Material &material) -> uint32_t {
+  MaterialKey key{material.shininess, material.opacity, material.specular.get()};
+  auto [it, added] = materialIds_.try_emplace(key, static_cast<uint32_t>(materialTable.size()));
+  if (added)
+	materialTable.push_back(material);
+  return it->second;
+}
+
+auto SceneTables::textureSetId(const std::vector<render::Texture *> &textures) -> uint32_t {
+  auto [it, added] = textureSetIds_.try_emplace(textures, static_cast<uint32_t>(textureSetTable.size()));
+  if (added)
+	textureSetTable.push_back(textures);
+  return it->second;
+}
+
+auto SceneTables::shininess(uint32_t slot) const -> float {
+  auto material = materials[slot];
+  return material!=NO_MATERIAL ? materialTable[material].shininess : render::Material{}.shininess;
+}
+
+auto SceneTables::lodRange(uint32_t slot, int lod) const -> LodRange {
+  if (lod==0)
+	return {draws[slot].first, draws[slot].count};
+  return lodRanges[lodFirst[slot] + lod - 1];
+}
+
+auto SceneTables::lodDraw(uint32_t slot, int lod) const -> DrawParams {
+  auto params = draws[slot];
+  if (lod > 0) {
+	auto &range = lodRanges[lodFirst[slot] + lod - 1];
+	params.first = range.first;
+	params.count = range.count;
+  }
+  return params;
+}
+
+auto SceneTables::syncTransform(uint32_t slot) -> void {
+  auto &object = objects[slot];
+  world[slot] = object->world_;
+  bounds[slot] = object->world_box_;
+  spheres[slot] = object->world_sphere_;
+  if (!(flags[slot] & DYNAMIC))
+	staticMoved = true;
+}
+
+auto SceneTables::syncState(uint32_t slot) -> void {
+  auto &object = objects[slot];
+  names[slot] = object->name_;
+  if (object->visible_)
+	flags[slot] |= VISIBLE;
+  else
+	flags[slot] &= ~VISIBLE;
+  if (object->occluder_)
+	flags[slot] |= OCCLUDER;
+  else
+	flags[slot] &= ~OCCLUDER;
+
+  shaders[slot] = object->shader_.get();
+  materials[slot] = object->material_ ? materialId(object->material_.value()) : NO_MATERIAL;
+  if (materials[slot]!=NO_MATERIAL && materialTable[materials[slot]].opacity < 1.0f)
+	flags[slot] |= TRANSLUCENT;
+  else
+	flags[slot] &= ~TRANSLUCENT;
+
+  std::vector<render::Texture *> textures;
+  for (auto &texture : object->textures_)
+	textures.push_back(texture.get());
+  textureSets[slot] = textureSetId(textures);
+}
+
+auto SceneTables::syncBodies() -> void {
+  for (auto slot : dynamicSlots) {
+	float mat[16];
+	bodies[slot]->getTransform().getOpenGLMatrix(mat);
+
+	// The body lives in world space while model_ is local to the parent node.
+	// setModel refreshes the bounds and calls back into syncTransform.
+	auto &object = objects[slot];
+	glm::mat4 body = glm::make_mat4(mat);
+	object->setModel(object->has_parent_ ? glm::inverse(object->parent_)*body : body);
+  }
+}
+
+auto SceneTables::processCustom() -> void {
+  for (auto slot : customSlots)
+	objects[slot]->process();
+}
@@ -0,0 +1,320 @@
+#include <geometry/StaticBatch.h>
+#include <geometry/SceneTables.h>
+#include <geometry/VertexLayout.h>
+#include <render/Camera.h>
+#include <render/GLState.h>
+#include <render/Shader.h>
+#include <render/Texture.h>
+
+#include <glad/glad.h>
+
+#include <unordered_map>
+
+using namespace omega::geometry;
+using namespace omega::render;
+
+StaticBatch::~StaticBatch() {
+  clear();
+}
+
+auto StaticBatch::clear() -> void {
+  for (auto &pool : pools_) {
+	glDeleteVertexArrays(1, &pool.vao);
+	glDeleteVertexArrays(1, &pool.indirectVao);
+	glDeleteBuffers(streamCount(pool.format), pool.streams.data());
+	glDeleteBuffers(1, &pool.ebo);
+	glDeleteBuffers(1, &pool.drawIds);
+  }
+
+  glDeleteBuffers(1, &ids_);
+  ids_ = 0;
+
+  records_.clear();
+  enabled_.clear();
+  draws_.clear();
+  groups_.clear();
+  pools_.clear();
+}
+
+auto StaticBatch::gpuCulling(bool enabled) -> void {
+  if (!enabled) {
+	culling_.reset();
+	return;
+  }
+  if (culling_ || !GpuCulling::supported())
+	return;
+
+  culling_ = std::make_unique<GpuCulling>();
+  if (!culling_->valid())
+	culling_.reset();
+}
+
+auto StaticBatch::build(const SceneTables &tables, const std::vector<uint32_t> &slots) -> void {
+  clear();
+  records_.assign(tables.size(), NONE);
+
+  // A vertex carries one draw id, meshes shared by several slots stay instanced
+  std::unordered_map<unsigned int, int> users;
+  for (auto slot : slots)
+	users[tables.draws[slot].vao]++;
+
+  for (auto slot : slots) {
+	auto &mesh = tables.objects[slot]->meshBuffers();
+	auto &params = tables.draws[slot];
+	if (users[params.vao]!=1 || params.type!=ObjectType::Elements || !mesh.ebo)
+	  continue;
+
+	unsigned int pool = 0;
+	while (pool < pools_.size() && (pools_[pool].format!=mesh.format || pools_[pool].indices!=mesh.indices))
+	  pool++;
+	if (pool==pools_.size())
+	  pools_.push_back({mesh.format, mesh.indices});
+
+	unsigned int group = 0;
+	while (group < groups_.size() && (groups_[group].pool!=pool || groups_[group].shader!=tables.shaders[slot] ||
+		groups_[group].textureSet!=tables.textureSets[slot]))
+	  group++;
+	if (group==groups_.size())
+	  groups_.push_back({pool, tables.shaders[slot], tables.textureSets[slot]});
+
+	auto &target = pools_[pool];
+	records_[slot] = static_cast<uint32_t>(draws_.size());
+	draws_.push_back({slot, group, mesh.indexCount, target.indexCount * indexSize(mesh.indices),
+					  static_cast<int>(target.vertexCount)});
+	target.vertexCount += mesh.vertices;
+	target.indexCount += mesh.indexCount;
+  }
+
+  if (culling_ && !draws_.empty()) {
+	std::vector<float> ids(draws_.size());
+	for (size_t record = 0; record < ids.size(); record++)
+	  ids[record] = static_cast<float>(record);
+	glGenBuffers(1, &ids_);
+	glBindBuffer(GL_ARRAY_BUFFER, ids_);
+	glBufferData(GL_ARRAY_BUFFER, ids.size() * sizeof(float), ids.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+  for (unsigned int pool = 0; pool < pools_.size(); pool++)
+	upload(tables, pool);
+
+  refresh(tables);
+}
+
+auto StaticBatch::upload(const SceneTables &tables, unsigned int index) -> void {
+  auto &pool = pools_[index];
+  int streams = streamCount(pool.format);
+  glGenVertexArrays(1, &pool.vao);
+  glGenBuffers(streams, pool.streams.data());
+  glGenBuffers(1, &pool.ebo);
+  glGenBuffers(1, &pool.drawIds);
+
+  // Copy every mesh on the GPU, the CPU side data is long gone
+  for (int stream = 0; stream < streams; stream++) {
+	size_t stride = streamStride(pool.format, stream);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, pool.streams[stream]);
+	glBufferData(GL_COPY_WRITE_BUFFER, pool.vertexCount * stride, nullptr, GL_STATIC_DRAW);
+	for (auto &draw : draws_) {
+	  if (groups_[draw.group].pool!=index)
+		continue;
+	  auto &mesh = tables.objects[draw.slot]->meshBuffers();
+	  glBindBuffer(GL_COPY_READ_BUFFER, mesh.streams[stream]);
+	  glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, draw.baseVertex * stride, mesh.vertices * stride);
+	}
+  }
+
+  size_t indexBytes = indexSize(pool.indices);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, pool.ebo);
+  glBufferData(GL_COPY_WRITE_BUFFER, pool.indexCount * indexBytes, nullptr, GL_STATIC_DRAW);
+  std::vector<float> ids(pool.vertexCount);
+  for (uint32_t record = 0; record < draws_.size(); record++) {
+	auto &draw = draws_[record];
+	if (groups_[draw.group].pool!=index)
+	  continue;
+	auto &mesh = tables.objects[draw.slot]->meshBuffers();
+	glBindBuffer(GL_COPY_READ_BUFFER, mesh.ebo);
+	glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, draw.indexOffset, draw.count * indexBytes);
+	std::fill_n(ids.begin() + draw.baseVertex, mesh.vertices, static_cast<float>(record));
+  }
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+  GLState::bindVertexArray(pool.vao);
+  setupVertexFormat(pool.format, pool.streams.data());
+
+  glBindBuffer(GL_ARRAY_BUFFER, pool.drawIds);
+  glBufferData(GL_ARRAY_BUFFER, ids.size() * sizeof(float), ids.data(), GL_STATIC_DRAW);
+  glEnableVertexAttribArray(DRAW_ID_LOCATION);
+  glVertexAttribPointer(DRAW_ID_LOCATION, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void *)0);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.ebo);
+
+  // Indirect commands carry the record as baseInstance, read the id per instance
+  if (ids_) {
+	glGenVertexArrays(1, &pool.indirectVao);
+	GLState::bindVertexArray(pool.indirectVao);
+	setupVertexFormat(pool.format, pool.streams.data());
+	glBindBuffer(GL_ARRAY_BUFFER, ids_);
+	glEnableVertexAttribArray(DRAW_ID_LOCATION);
+	glVertexAttribPointer(DRAW_ID_LOCATION, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void *)0);
+	glVertexAttribDivisor(DRAW_ID_LOCATION, 1);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.ebo);
+  }
+
+  GLState::bindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+auto StaticBatch::refresh(const SceneTables &tables) -> void {
+  if (draws_.empty())
+	return;
+
+  data_.clear();
+  for (auto &draw : draws_)
+	data_.push(tables.world[draw.slot], tables.shininess(draw.slot));
+  data_.upload();
+
+  // Moved slots moved their bounds too
+  if (culling_)
+	uploadRecords(tables);
+}
+
+auto StaticBatch::uploadRecords(const SceneTables &tables) -> void {
+  std::vector<GpuCullRecord> records(draws_.size());
+  std::vector<unsigned int> groupSizes(groups_.size(), 0);
+  enabled_.resize(draws_.size());
+
+  for (size_t index = 0; index < draws_.size(); index++) {
+	auto &draw = draws_[index];
+	auto &record = records[index];
+	auto &bounds = tables.bounds[draw.slot];
+	enabled_[index] = (tables.flags[draw.slot] & SceneTables::VISIBLE) && covers(tables, draw.slot);
+
+	bool bounded = tables.flags[draw.slot] & SceneTables::BOUNDED;
+	record.boxMin = glm::vec4(bounds.minExtents.x, bounds.minExtents.y, bounds.minExtents.z, enabled_[index] ? 1.0f : 0.0f);
+	record.boxMax = glm::vec4(bounds.maxExtents.x, bounds.maxExtents.y, bounds.maxExtents.z, bounded ? 1.0f : 0.0f);
+	record.firsts = glm::uvec4(0);
+	record.counts = glm::uvec4(0);
+	auto base = static_cast<unsigned int>(draw.indexOffset / indexSize(pools_[groups_[draw.group].pool].indices));
+	for (int lod = 0; lod < tables.lodCount(draw.slot) && lod < MAX_LODS; lod++) {
+	  auto range = tables.lodRange(draw.slot, lod);
+	  record.firsts[lod] = base + range.first;
+	  record.counts[lod] = range.count;
+	}
+	record.draw = glm::ivec4(draw.baseVertex, static_cast<int>(draw.group), 0, 0);
+	groupSizes[draw.group]++;
+  }
+
+  culling_->upload(records, groupSizes);
+}
+
+auto StaticBatch::covers(const SceneTables &tables, uint32_t slot) const -> bool {
+  if (slot >= records_.size() || records_[slot]==NONE)
+	return false;
+
+  // Turned translucent since the build, it belongs in the blended pass
+  if (tables.flags[slot] & SceneTables::TRANSLUCENT)
+	return false;
+
+  // Program or textures changed since the build, the slot draws on its own
+  auto &group = groups_[draws_[records_[slot]].group];
+  return tables.shaders[slot]==group.shader && tables.textureSets[slot]==group.textureSet;
+}
+
+auto StaticBatch::prepare(const SceneTables &tables, const std::vector<uint32_t> &visible,
+						  const std::vector<uint8_t> &lods, const std::shared_ptr<render::Camera> &camera,
+						  uint64_t view) -> void {
+  if (draws_.empty())
+	return;
+
+  if (culling_) {
+	refreshEnabled(tables);
+	culling_->cull(*camera, view);
+	return;
+  }
+
+  for (auto &group : groups_) {
+	group.counts.clear();
+	group.offsets.clear();
+	group.baseVertices.clear();
+  }
+
+  for (auto slot : visible) {
+	if (!(tables.flags[slot] & SceneTables::VISIBLE) || !covers(tables, slot))
+	  continue;
+	auto &draw = draws_[records_[slot]];
+	auto &group = groups_[draw.group];
+	auto range = tables.lodRange(slot, lods[slot]);
+	group.counts.push_back(static_cast<int>(range.count));
+	group.offsets.push_back(reinterpret_cast<const void *>(draw.indexOffset +
+		size_t(range.first) * indexSize(pools_[group.pool].indices)));
+	group.baseVertices.push_back(draw.baseVertex);
+  }
+}
+
+auto StaticBatch::refreshEnabled(const SceneTables &tables) -> void {
+  // Hidden or detached slots are switched off in the records, only re-upload when one flips
+  for (size_t index = 0; index < draws_.size(); index++) {
+	auto slot = draws_[index].slot;
+	bool enabled = (tables.flags[slot] & SceneTables::VISIBLE) && covers(tables, slot);
+	if (enabled!=static_cast<bool>(enabled_[index])) {
+	  uploadRecords(tables);
+	  return;
+	}
+  }
+}
+
+auto StaticBatch::draw(const SceneTables &tables, const std::shared_ptr<render::Camera> &camera,
+					   render::Shader *program, bool textures) -> void {
+  if (draws_.empty())
+	return;
+
+  data_.bind();
+  for (unsigned int index = 0; index < groups_.size(); index++) {
+	auto &group = groups_[index];
+	if (!culling_ && group.counts.empty())
+	  continue;
+
+	auto *shader = program ? program : group.shader;
+	auto &uniforms = shader->objectUniforms();
+	shader->use();
+	if (uniforms.projection.valid())
+	  shader->set(uniforms.projection, camera->projectionMatrix());
+	if (uniforms.view.valid())
+	  shader->set(uniforms.view, camera->viewMatrix());
+	if (uniforms.viewPos.valid())
+	  shader->set(uniforms.viewPos, camera->position());
+
+	if (textures) {
+	  auto &set = tables.textureSetTable[group.textureSet];
+	  for (int no = 0; no < set.size(); no++)
+		set[no]->activate(no);
+	}
+
+	auto &pool = pools_[group.pool];
+	shader->set(uniforms.instanced, 1);
+	shader->set(uniforms.batched, 1);
+	shader->set(uniforms.transparency, 0.0f);
+	shader->set(uniforms.compactNormals, pool.format!=VertexFormat::Full ? 1 : 0);
+	if (culling_) {
+	  GLState::bindVertexArray(pool.indirectVao);
+	  culling_->draw(index, indexGLType(pool.indices));
+	} else {
+	  GLState::bindVertexArray(pool.vao);
+	  glMultiDrawElementsBaseVertex(GL_TRIANGLES, group.counts.data(), indexGLType(pool.indices),
+									group.offsets.data(), static_cast<int>(group.counts.size()),
+									group.baseVertices.data());
+	}
+	shader->set(uniforms.batched, 0);
+  }
+}
+
+auto StaticBatch::captureDepth(render::Camera &camera, uint64_t view, const glm::ivec4 &viewport) -> void {
+  if (culling_ && !draws_.empty())
+	culling_->capture(camera, view, viewport);
+}
+
+auto StaticBatch::forgetView(uint64_t view) -> void {
+  if (culling_)
+	culling_->forget(view);
+}
@@ -0,0 +1,91 @@
+#include <geometry/VertexLayout.h>
+
+#include <glm/gtc/packing.hpp>
+#include <cmath>
+
+namespace omega {
+namespace geometry {
+
+static_assert(FullLayout::VERTEX_SIZE == 56, "Vertex is expected to stay 56 bytes");
+static_assert(CompactLayout::VERTEX_SIZE == 20, "compact vertex is 20 bytes");
+static_assert(CompactTangentLayout::VERTEX_SIZE == 28, "compact vertex with tangent is 28 bytes");
+
+auto streamCount(VertexFormat format) -> int {
+  switch (format) {
+  case VertexFormat::Compact:
+	return CompactLayout::STREAMS;
+  case VertexFormat::CompactTangent:
+	return CompactTangentLayout::STREAMS;
+  default:
+	return FullLayout::STREAMS;
+  }
+}
+
+auto streamStride(VertexFormat format, int stream) -> int {
+  switch (format) {
+  case VertexFormat::Compact:
+	return CompactLayout::STRIDES[stream];
+  case VertexFormat::CompactTangent:
+	return CompactTangentLayout::STRIDES[stream];
+  default:
+	return FullLayout::STRIDES[stream];
+  }
+}
+
+auto setupVertexFormat(VertexFormat format, const unsigned int *buffers) -> void {
+  switch (format) {
+  case VertexFormat::Compact:
+	CompactLayout::setup(buffers);
+	break;
+  case VertexFormat::CompactTangent:
+	CompactTangentLayout::setup(buffers);
+	break;
+  default:
+	FullLayout::setup(buffers);
+	break;
+  }
+}
+
+auto indexSize(IndexType type) -> int {
+  return type==IndexType::U16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+auto indexGLType(IndexType type) -> unsigned int {
+  return type==IndexType::U16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+}
+
+// Octahedral mapping of a unit vector onto [-1, 1]^2
+static auto octEncode(glm::vec3 n) -> glm::vec2 {
+  float length = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+  if (length <= 0.0f)
+	return glm::vec2(0.0f);
+  n /= length;
+
+  glm::vec2 p(n.x, n.y);
+  if (n.z < 0.0f) {
+	p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) *
+		glm::vec2(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+  }
+  return p;
+}
+
+static auto snorm16(float value) -> int16_t {
+  return static_cast<int16_t>(glm::packSnorm1x16(value));
+}
+
+auto packSurface(const Vertex &vertex) -> PackedSurface {
+  auto normal = octEncode(vertex.normal);
+  return {{snorm16(normal.x), snorm16(normal.y)},
+		  {glm::packHalf1x16(vertex.uv.x), glm::packHalf1x16(vertex.uv.y)}};
+}
+
+auto packTangent(const Vertex &vertex) -> PackedTangent {
+  auto tangent = octEncode(vertex.tangent);
+
+  // Handedness of the tangent frame, the bitangent is rebuilt as sign * cross(n, t)
+  float sign = glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+  return {{snorm16(tangent.x), snorm16(tangent.y), 0, snorm16(sign)}};
+}
+
+}  // namespace geometry
+}  // namespace omega
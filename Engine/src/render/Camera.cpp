@@ -97,6 +97,49 @@ auto Camera::setLookAt(glm::vec3 lookAt) -> void {
 auto Camera::setPerspective(float const &fov, float const &width, float const &height,
 							float const &near, float const &far) -> void {
   projection_matrix_ = glm::perspectiveFov(fov, width, height, near, far);
+  near_ = near;
+  far_ = far;
+}
+
+auto Camera::frustum() -> const std::array<geometry::Plane<float>, 6> & {
+  glm::mat4 viewProj = cullingProjection()*viewMatrix();
+  if (viewProj==frustum_view_proj_)
+	return frustum_;
+  frustum_view_proj_ = viewProj;
+
+  // Gribb/Hartmann: each plane is the w row plus or minus one of the x, y, z rows
+  auto row = [&viewProj](int i) {
+	return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+  };
+  const glm::vec4 planes[6] = {row(3) + row(0), row(3) - row(0),
+							   row(3) + row(1), row(3) - row(1),
+							   row(3) + row(2), row(3) - row(2)};
+  for (int i = 0; i < 6; i++) {
+	float len = glm::length(glm::vec3(planes[i]));
+	glm::vec4 p = planes[i]/len;
+	frustum_[i] = geometry::Plane<float>(p.x, p.y, p.z, p.w);
+  }
+  return frustum_;
+}
+
+auto Camera::isVisible(const geometry::Box3<float> &box) -> bool {
+  for (auto &plane : frustum()) {
+	// Test the corner furthest along the plane normal
+	geometry::Point3<float> corner(plane.x >= 0 ? box.maxExtents.x : box.minExtents.x,
+								   plane.y >= 0 ? box.maxExtents.y : box.minExtents.y,
+								   plane.z >= 0 ? box.maxExtents.z : box.minExtents.z);
+	if (plane.distTPlane(corner) < 0)
+	  return false;
+  }
+  return true;
+}
+
+auto Camera::isVisible(const geometry::Sphere<float> &sphere) -> bool {
+  for (auto &plane : frustum()) {
+	if (plane.distTPlane(sphere.center) < -sphere.radius)
+	  return false;
+  }
+  return true;
 }
 
 glm::mat4x4 Camera::calculate_lookAt_matrix(glm::vec3 position, glm::vec3 target,
@@ -1,4 +1,5 @@
 #include <render/CubeTexture.h>
+#include <render/GLState.h>
 #include <system/FileSystem.h>
 
 #include <iostream>
@@ -11,7 +12,7 @@ bool CubeTexture::load(input::CubeTextureInput input) {
   std::vector<std::string> faces{input.right,  input.left,  input.top,
                                  input.bottom, input.front, input.back};
   glGenTextures(1, &m_textureId);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, m_textureId);
+  GLState::bindTexture(GLState::UPLOAD_UNIT, GL_TEXTURE_CUBE_MAP, m_textureId);
 
   for (unsigned int i = 0; i < faces.size(); i++) {
     auto imageInfo = loadImageData(faces[i], false);
@@ -37,7 +38,6 @@ bool CubeTexture::load(input::CubeTextureInput input) {
 
 bool CubeTexture::activate(int no) {
   // bind textures on corresponding texture units
-  glActiveTexture(GL_TEXTURE0 + no);
-  glBindTexture(GL_TEXTURE_CUBE_MAP, m_textureId);
+  GLState::bindTexture(no, GL_TEXTURE_CUBE_MAP, m_textureId);
   return true;
 }
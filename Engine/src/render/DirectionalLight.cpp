@@ -9,12 +9,23 @@ void DirectionalLight::setup(std::shared_ptr<render::Shader> shader) {
     std::cout << "Light not used because of MAX_POINT limit" << std::endl;
     return;
   }
-  auto no = std::to_string(point_no);
-  shader->setVec3("dirLight[" + no + "].direction", direction_);
-  shader->setVec3("dirLight[" + no + "].ambient", ambient_);
-  shader->setVec3("dirLight[" + no + "].diffuse", diffuse_);
-  shader->setVec3("dirLight[" + no + "].specular", specular_);
-  shader->setInt("dirLight[" + no + "].on", 1);
+  auto& slot = shader->directionalLight(point_no);
+  shader->use();
+  shader->set(slot.direction, direction_);
+  shader->set(slot.ambient, ambient_);
+  shader->set(slot.diffuse, diffuse_);
+  shader->set(slot.specular, specular_);
+  shader->set(slot.on, 1);
+}
+
+auto DirectionalLight::pack(interface::GpuLight& light) -> bool {
+  light.position = glm::vec4(0.0f, 0.0f, 0.0f, float(interface::LightType::DIRECTIONAL));
+  light.direction = glm::vec4(direction_, INFINITY);
+  light.ambient = glm::vec4(ambient_, 1.0f);
+  light.diffuse = glm::vec4(diffuse_, 0.0f);
+  light.specular = glm::vec4(specular_, 0.0f);
+  light.cone = glm::vec4(0.0f);
+  return true;
 }
 
 void DirectionalLight::dump() {
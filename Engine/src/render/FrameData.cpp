@@ -0,0 +1,37 @@
+#include <render/FrameData.h>
+#include <render/Camera.h>
+#include <glad/glad.h>
+
+using namespace omega::render;
+
+static_assert(sizeof(FrameData::Block) == 3 * 64 + 32, "FrameData::Block must match the std140 layout");
+
+FrameData::FrameData() {
+  glGenBuffers(1, &ubo_);
+  glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ubo_);
+}
+
+FrameData::~FrameData() {
+  if (ubo_ != 0) {
+    glDeleteBuffers(1, &ubo_);
+  }
+}
+
+void FrameData::update(Camera& camera, float time, const glm::vec4& ambient) {
+  block_.view = camera.viewMatrix();
+  block_.projection = camera.projectionMatrix();
+  block_.viewProj = block_.projection * block_.view;
+  block_.viewPos = camera.position();
+  block_.time = time;
+  block_.ambient = ambient;
+
+  // Orphan the previous contents so a view still in flight does not stall the upload
+  glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block_);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ubo_);
+}
@@ -0,0 +1,94 @@
+#include <render/GBuffer.h>
+#include <render/Camera.h>
+#include <render/GLState.h>
+#include <render/Shader.h>
+#include <glad/glad.h>
+
+#include <iostream>
+
+using namespace omega::render;
+
+GBuffer::GBuffer() {
+  lighting_ = Shader::fromFile(3, 3, ":/shaders/deferred.vs", ":/shaders/deferred.fs");
+  glGenVertexArrays(1, &vao_);
+}
+
+GBuffer::~GBuffer() {
+  destroy();
+  glDeleteVertexArrays(1, &vao_);
+}
+
+void GBuffer::destroy() {
+  glDeleteFramebuffers(1, &fbo_);
+  GLState::forgetTexture(albedo_);
+  GLState::forgetTexture(surface_);
+  GLState::forgetTexture(depth_);
+  glDeleteTextures(1, &albedo_);
+  glDeleteTextures(1, &surface_);
+  glDeleteTextures(1, &depth_);
+  fbo_ = albedo_ = surface_ = depth_ = 0;
+}
+
+auto GBuffer::attach(unsigned int attachment, int internalFormat, unsigned int format, unsigned int type)
+    -> unsigned int {
+  unsigned int texture;
+  glGenTextures(1, &texture);
+  GLState::bindTexture(ALBEDO_UNIT, GL_TEXTURE_2D, texture);
+  glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size_.x, size_.y, 0, format, type, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, texture, 0);
+  return texture;
+}
+
+void GBuffer::allocate(const glm::ivec2& size) {
+  destroy();
+  size_ = size;
+
+  glGenFramebuffers(1, &fbo_);
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  albedo_ = attach(GL_COLOR_ATTACHMENT0, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE);
+  surface_ = attach(GL_COLOR_ATTACHMENT1, GL_RGBA16F, GL_RGBA, GL_HALF_FLOAT);
+  depth_ = attach(GL_DEPTH_ATTACHMENT, GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT);
+
+  const GLenum buffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+  glDrawBuffers(2, buffers);
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    std::cout << "[GBuffer] Framebuffer incomplete at " << size.x << "x" << size.y << std::endl;
+}
+
+void GBuffer::begin(const glm::ivec4& viewport) {
+  glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target_);
+  viewport_ = viewport;
+
+  glm::ivec2 size(viewport.z, viewport.w);
+  if (size != size_)
+    allocate(size);
+
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+  glViewport(0, 0, size_.x, size_.y);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void GBuffer::resolve(Camera& camera) {
+  glBindFramebuffer(GL_FRAMEBUFFER, target_);
+  glViewport(viewport_.x, viewport_.y, viewport_.z, viewport_.w);
+
+  GLState::bindTexture(ALBEDO_UNIT, GL_TEXTURE_2D, albedo_);
+  GLState::bindTexture(SURFACE_UNIT, GL_TEXTURE_2D, surface_);
+  GLState::bindTexture(DEPTH_UNIT, GL_TEXTURE_2D, depth_);
+
+  auto& program = *lighting_;
+  program.use();
+  program.set(program.uniform("albedo"), ALBEDO_UNIT);
+  program.set(program.uniform("surface"), SURFACE_UNIT);
+  program.set(program.uniform("depth"), DEPTH_UNIT);
+  program.set(program.uniform("inverseViewProjection"),
+              glm::inverse(camera.projectionMatrix() * camera.viewMatrix()));
+
+  // Every pixel passes and carries its G-buffer depth into the target
+  glDepthFunc(GL_ALWAYS);
+  GLState::bindVertexArray(vao_);
+  glDrawArrays(GL_TRIANGLES, 0, 3);
+  glDepthFunc(GL_LESS);
+}
@@ -0,0 +1,81 @@
+#include <render/GLState.h>
+#include <glad/glad.h>
+
+using namespace omega::render;
+
+unsigned int GLState::program_{GLState::UNKNOWN};
+unsigned int GLState::vao_{GLState::UNKNOWN};
+int GLState::activeUnit_{-1};
+std::array<std::array<unsigned int, GLState::TARGETS>, GLState::MAX_TEXTURE_UNITS> GLState::textures_ = [] {
+  std::array<std::array<unsigned int, GLState::TARGETS>, GLState::MAX_TEXTURE_UNITS> units;
+  for (auto& unit : units)
+    unit.fill(GLState::UNKNOWN);
+  return units;
+}();
+
+void GLState::useProgram(unsigned int program) {
+  if (program_ == program)
+    return;
+  glUseProgram(program);
+  program_ = program;
+}
+
+void GLState::bindVertexArray(unsigned int vao) {
+  if (vao_ == vao)
+    return;
+  glBindVertexArray(vao);
+  vao_ = vao;
+}
+
+auto GLState::targetIndex(unsigned int target) -> int {
+  switch (target) {
+  case GL_TEXTURE_2D:
+    return 0;
+  case GL_TEXTURE_CUBE_MAP:
+    return 1;
+  case GL_TEXTURE_BUFFER:
+    return 2;
+  default:
+    return -1;
+  }
+}
+
+void GLState::bindTexture(int unit, unsigned int target, unsigned int texture) {
+  int index = targetIndex(target);
+  bool cached = index >= 0 && unit >= 0 && unit < MAX_TEXTURE_UNITS;
+  if (cached && textures_[unit][index] == texture)
+    return;
+
+  activeTexture(unit);
+  glBindTexture(target, texture);
+
+  if (cached)
+    textures_[unit][index] = texture;
+}
+
+void GLState::activeTexture(int unit) {
+  if (activeUnit_ == unit)
+    return;
+  glActiveTexture(GL_TEXTURE0 + unit);
+  activeUnit_ = unit;
+}
+
+void GLState::forgetProgram(unsigned int program) {
+  if (program_ == program)
+    program_ = UNKNOWN;
+}
+
+void GLState::forgetTexture(unsigned int texture) {
+  for (auto& unit : textures_)
+    for (auto& bound : unit)
+      if (bound == texture)
+        bound = 0;
+}
+
+void GLState::invalidate() {
+  program_ = UNKNOWN;
+  vao_ = UNKNOWN;
+  activeUnit_ = -1;
+  for (auto& unit : textures_)
+    unit.fill(UNKNOWN);
+}
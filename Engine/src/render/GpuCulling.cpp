@@ -0,0 +1,237 @@
+#include <render/GpuCulling.h>
+#include <render/Camera.h>
+#include <render/GLState.h>
+#include <render/Shader.h>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace omega::render;
+using namespace omega::geometry;
+
+static_assert(sizeof(GpuCullRecord) == 5 * sizeof(glm::vec4), "GpuCullRecord is read as a std430 struct");
+
+namespace {
+
+// DrawElementsIndirectCommand, five tightly packed uints
+constexpr size_t COMMAND_SIZE = 5 * sizeof(unsigned int);
+
+enum Binding : unsigned int {
+  RECORDS = 0,
+  COMMANDS = 1,
+  COUNTS = 2,
+};
+
+}  // namespace
+
+auto GpuCulling::supported() -> bool {
+  return GLAD_GL_ARB_compute_shader && GLAD_GL_ARB_shader_storage_buffer_object &&
+	  GLAD_GL_ARB_shader_image_load_store && GLAD_GL_ARB_program_interface_query &&
+	  GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_base_instance;
+}
+
+GpuCulling::GpuCulling() {
+  cullProgram_ = Shader::computeFromFile(4, 3, ":/shaders/cull.cs");
+  reduceProgram_ = Shader::computeFromFile(4, 3, ":/shaders/hiz.cs");
+  valid_ = cullProgram_->linked() && reduceProgram_->linked();
+  if (!valid_) {
+	std::cout << "[GpuCulling] Culling programs did not link, staying on the CPU path" << std::endl;
+	return;
+  }
+  compact_ = GLAD_GL_ARB_indirect_parameters;
+
+  glGenBuffers(1, &records_);
+  glGenBuffers(1, &commands_);
+  glGenBuffers(1, &counts_);
+
+  // The GLSL version has no binding layout qualifiers, wire the blocks up here
+  bindStorage(*cullProgram_, "Records", RECORDS);
+  bindStorage(*cullProgram_, "Commands", COMMANDS);
+  bindStorage(*cullProgram_, "Counts", COUNTS);
+}
+
+GpuCulling::~GpuCulling() {
+  for (auto &[view, pyramid] : pyramids_) {
+	GLState::forgetTexture(pyramid.depth);
+	GLState::forgetTexture(pyramid.texture);
+	glDeleteTextures(1, &pyramid.depth);
+	glDeleteTextures(1, &pyramid.texture);
+  }
+  if (valid_) {
+	glDeleteBuffers(1, &records_);
+	glDeleteBuffers(1, &commands_);
+	glDeleteBuffers(1, &counts_);
+  }
+}
+
+auto GpuCulling::bindStorage(Shader &program, const char *block, unsigned int binding) -> void {
+  auto index = glGetProgramResourceIndex(program.programId(), GL_SHADER_STORAGE_BLOCK, block);
+  if (index!=GL_INVALID_INDEX)
+	glShaderStorageBlockBinding(program.programId(), index, binding);
+}
+
+auto GpuCulling::upload(const std::vector<GpuCullRecord> &records, const std::vector<unsigned int> &groupSizes) -> void {
+  if (!valid_)
+	return;
+
+  groupSizes_ = groupSizes;
+  groupFirst_.assign(groupSizes.size(), 0);
+  unsigned int total = 0;
+  for (size_t group = 0; group < groupSizes.size(); group++) {
+	groupFirst_[group] = total;
+	total += groupSizes[group];
+  }
+
+  // Give every record its fixed command, compaction only uses the group's start
+  std::vector<GpuCullRecord> placed(records);
+  std::vector<unsigned int> used(groupSizes.size(), 0);
+  for (auto &record : placed) {
+	auto group = static_cast<unsigned int>(record.draw.y);
+	record.draw.z = static_cast<int>(groupFirst_[group]);
+	record.draw.w = static_cast<int>(used[group]++);
+  }
+  recordCount_ = static_cast<unsigned int>(placed.size());
+  zeros_.assign(std::max<size_t>(groupSizes.size(), 1), 0);
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, records_);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, std::max<size_t>(placed.size(), 1) * sizeof(GpuCullRecord), placed.data(),
+			   GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, commands_);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, std::max(total, 1u) * COMMAND_SIZE, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, counts_);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, zeros_.size() * sizeof(unsigned int), zeros_.data(), GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+auto GpuCulling::cull(Camera &camera, uint64_t view) -> void {
+  if (!valid_ || recordCount_==0)
+	return;
+
+  if (compact_) {
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, counts_);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, zeros_.size() * sizeof(unsigned int), zeros_.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+  }
+
+  auto &program = *cullProgram_;
+  glm::mat4 viewMatrix = camera.viewMatrix();
+  program.use();
+  program.set(program.uniform("viewProjection"), camera.cullingProjection() * viewMatrix);
+  program.set(program.uniform("eye"), glm::vec3(glm::inverse(viewMatrix)[3]));
+  program.set(program.uniform("lodScale"), camera.screenProjection()[1][1]);
+  program.set(program.uniform("lodThresholds"), glm::vec3(LOD_SCREEN_SIZE[0], LOD_SCREEN_SIZE[1], LOD_SCREEN_SIZE[2]));
+  program.set(program.uniform("recordCount"), static_cast<int>(recordCount_));
+  program.set(program.uniform("compact"), compact_ ? 1 : 0);
+
+  auto found = pyramids_.find(view);
+  bool hiZ = found!=pyramids_.end() && found->second.ready;
+  program.set(program.uniform("useHiZ"), hiZ ? 1 : 0);
+  if (hiZ) {
+	auto &pyramid = found->second;
+	GLState::bindTexture(HI_Z_UNIT, GL_TEXTURE_2D, pyramid.texture);
+	program.set(program.uniform("hiZ"), HI_Z_UNIT);
+	program.set(program.uniform("hiZViewProjection"), pyramid.viewProjection);
+	program.set(program.uniform("hiZLevels"), pyramid.levels);
+  }
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RECORDS, records_);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMANDS, commands_);
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COUNTS, counts_);
+  glDispatchCompute((recordCount_ + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+auto GpuCulling::draw(unsigned int group, unsigned int indexType) -> void {
+  if (!valid_ || group >= groupSizes_.size() || groupSizes_[group]==0)
+	return;
+
+  auto *first = reinterpret_cast<const void *>(groupFirst_[group] * COMMAND_SIZE);
+  auto maxCount = static_cast<GLsizei>(groupSizes_[group]);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands_);
+  if (compact_) {
+	glBindBuffer(GL_PARAMETER_BUFFER_ARB, counts_);
+	glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, indexType, first, group * sizeof(unsigned int), maxCount, 0);
+	glBindBuffer(GL_PARAMETER_BUFFER_ARB, 0);
+  } else {
+	glMultiDrawElementsIndirect(GL_TRIANGLES, indexType, first, maxCount, 0);
+  }
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+auto GpuCulling::capture(Camera &camera, uint64_t view, const glm::ivec4 &viewport) -> void {
+  if (!valid_ || recordCount_==0 || viewport.z <= 0 || viewport.w <= 0)
+	return;
+
+  auto &pyramid = pyramids_[view];
+
+  glm::ivec2 size(viewport.z, viewport.w);
+  if (pyramid.size!=size) {
+	GLState::forgetTexture(pyramid.depth);
+	GLState::forgetTexture(pyramid.texture);
+	glDeleteTextures(1, &pyramid.depth);
+	glDeleteTextures(1, &pyramid.texture);
+	glGenTextures(1, &pyramid.depth);
+	glGenTextures(1, &pyramid.texture);
+	pyramid.size = size;
+
+	GLState::bindTexture(HI_Z_UNIT, GL_TEXTURE_2D, pyramid.depth);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, size.x, size.y, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT,
+				 nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glm::ivec2 level = glm::max((size + 1) / 2, glm::ivec2(1));
+	pyramid.levels = 1 + static_cast<int>(std::floor(std::log2(std::max(level.x, level.y))));
+	GLState::bindTexture(HI_Z_UNIT, GL_TEXTURE_2D, pyramid.texture);
+	for (int i = 0; i < pyramid.levels; i++) {
+	  glTexImage2D(GL_TEXTURE_2D, i, GL_R32F, level.x, level.y, 0, GL_RED, GL_FLOAT, nullptr);
+	  level = glm::max((level + 1) / 2, glm::ivec2(1));
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, pyramid.levels - 1);
+  }
+
+  GLState::bindTexture(HI_Z_UNIT, GL_TEXTURE_2D, pyramid.depth);
+  GLState::activeTexture(HI_Z_UNIT);
+  glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, viewport.x, viewport.y, size.x, size.y);
+
+  // Level 0 reduces the copied depth, every further level the one above it
+  auto &program = *reduceProgram_;
+  program.use();
+  program.set(program.uniform("depthSource"), HI_Z_UNIT);
+  program.set(program.uniform("target"), 0);
+  program.set(program.uniform("source"), 1);
+  glm::ivec2 source = size;
+  for (int level = 0; level < pyramid.levels; level++) {
+	glm::ivec2 target = glm::max((source + 1) / 2, glm::ivec2(1));
+	glBindImageTexture(0, pyramid.texture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	if (level > 0)
+	  glBindImageTexture(1, pyramid.texture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+	program.set(program.uniform("fromDepth"), level==0 ? 1 : 0);
+	program.set(program.uniform("sourceSize"), glm::vec2(source));
+	program.set(program.uniform("targetSize"), glm::vec2(target));
+	glDispatchCompute((target.x + 7) / 8, (target.y + 7) / 8, 1);
+	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	source = target;
+  }
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+  pyramid.viewProjection = camera.projectionMatrix() * camera.viewMatrix();
+  pyramid.ready = true;
+}
+
+auto GpuCulling::forget(uint64_t view) -> void {
+  auto found = pyramids_.find(view);
+  if (found==pyramids_.end())
+	return;
+  GLState::forgetTexture(found->second.depth);
+  GLState::forgetTexture(found->second.texture);
+  glDeleteTextures(1, &found->second.depth);
+  glDeleteTextures(1, &found->second.texture);
+  pyramids_.erase(found);
+}
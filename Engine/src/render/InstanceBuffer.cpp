@@ -0,0 +1,49 @@
+#include <render/InstanceBuffer.h>
+#include <render/GLState.h>
+#include <glad/glad.h>
+
+using namespace omega::render;
+
+static_assert(sizeof(GpuInstance) == InstanceBuffer::INSTANCE_TEXELS * sizeof(glm::vec4),
+              "GpuInstance is read as INSTANCE_TEXELS RGBA32F texels");
+
+InstanceBuffer::InstanceBuffer() {
+  glGenBuffers(1, &buffer_);
+  glGenTextures(1, &texture_);
+
+  GpuInstance empty;
+  glBindBuffer(GL_TEXTURE_BUFFER, buffer_);
+  glBufferData(GL_TEXTURE_BUFFER, sizeof(GpuInstance), &empty, GL_STREAM_DRAW);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+  GLState::bindTexture(INSTANCE_DATA_UNIT, GL_TEXTURE_BUFFER, texture_);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer_);
+}
+
+InstanceBuffer::~InstanceBuffer() {
+  GLState::forgetTexture(texture_);
+  glDeleteTextures(1, &texture_);
+  glDeleteBuffers(1, &buffer_);
+}
+
+auto InstanceBuffer::push(const glm::mat4& model, float shininess) -> unsigned int {
+  instances_.push_back({model, glm::vec4(shininess, 0.0f, 0.0f, 0.0f)});
+  return static_cast<unsigned int>(instances_.size() - 1);
+}
+
+void InstanceBuffer::upload() {
+  if (!instances_.empty()) {
+    // Orphan and refill, earlier views may still be reading the old contents
+    size_t size = instances_.size() * sizeof(GpuInstance);
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer_);
+    glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_TEXTURE_BUFFER, 0, size, instances_.data());
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+  }
+
+  bind();
+}
+
+void InstanceBuffer::bind() {
+  GLState::bindTexture(INSTANCE_DATA_UNIT, GL_TEXTURE_BUFFER, texture_);
+}
@@ -0,0 +1,205 @@
+#include <render/LightClusters.h>
+#include <render/Camera.h>
+#include <render/GLState.h>
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace omega::render;
+using namespace omega::interface;
+
+static_assert(sizeof(GpuLight) == 6 * sizeof(glm::vec4), "GpuLight is read as six RGBA32F texels");
+
+LightClusters::LightClusters() {
+  glGenBuffers(1, &ubo_);
+  glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  glGenBuffers(1, &lightBuffer_);
+  glGenBuffers(1, &gridBuffer_);
+  glGenBuffers(1, &indexBuffer_);
+  glGenTextures(1, &lightTexture_);
+  glGenTextures(1, &gridTexture_);
+  glGenTextures(1, &indexTexture_);
+
+  // Give every buffer storage before attaching it to its texture
+  GpuLight empty;
+  upload(lightBuffer_, sizeof(GpuLight), &empty);
+  grid_.assign(CLUSTER_COUNT, glm::uvec2(0));
+  upload(gridBuffer_, grid_.size() * sizeof(glm::uvec2), grid_.data());
+  unsigned int zero = 0;
+  upload(indexBuffer_, sizeof(zero), &zero);
+
+  GLState::bindTexture(LIGHT_DATA_UNIT, GL_TEXTURE_BUFFER, lightTexture_);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, lightBuffer_);
+  GLState::bindTexture(CLUSTER_GRID_UNIT, GL_TEXTURE_BUFFER, gridTexture_);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, gridBuffer_);
+  GLState::bindTexture(LIGHT_INDEX_UNIT, GL_TEXTURE_BUFFER, indexTexture_);
+  glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, indexBuffer_);
+}
+
+LightClusters::~LightClusters() {
+  GLState::forgetTexture(lightTexture_);
+  GLState::forgetTexture(gridTexture_);
+  GLState::forgetTexture(indexTexture_);
+  glDeleteTextures(1, &lightTexture_);
+  glDeleteTextures(1, &gridTexture_);
+  glDeleteTextures(1, &indexTexture_);
+  glDeleteBuffers(1, &lightBuffer_);
+  glDeleteBuffers(1, &gridBuffer_);
+  glDeleteBuffers(1, &indexBuffer_);
+  glDeleteBuffers(1, &ubo_);
+}
+
+void LightClusters::upload(unsigned int buffer, size_t size, const void* data) {
+  // Orphan and refill, the previous contents may still be in use by the GPU
+  glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+  glBufferData(GL_TEXTURE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+  glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void LightClusters::updateLights(const std::vector<std::shared_ptr<Light>>& lights) {
+  lights_.clear();
+  directionalCount_ = 0;
+
+  // Directional lights first, they are not binned
+  for (auto& light : lights) {
+    if (light->type() != LightType::DIRECTIONAL)
+      continue;
+    GpuLight packed;
+    if (light->pack(packed)) {
+      lights_.push_back(packed);
+      directionalCount_++;
+    }
+  }
+
+  for (auto& light : lights) {
+    if (light->type() == LightType::DIRECTIONAL)
+      continue;
+    GpuLight packed;
+    if (light->pack(packed))
+      lights_.push_back(packed);
+  }
+
+  if (!lights_.empty())
+    upload(lightBuffer_, lights_.size() * sizeof(GpuLight), lights_.data());
+}
+
+auto LightClusters::slice(float depth, float scale, float bias) const -> int {
+  return std::clamp(static_cast<int>(std::floor(std::log(depth) * scale - bias)), 0, GRID_Z - 1);
+}
+
+void LightClusters::build(Camera& camera, const glm::ivec4& viewport) {
+  glm::mat4 view = camera.viewMatrix();
+  glm::mat4 projection = camera.projectionMatrix();
+  float nearPlane = camera.nearPlane();
+  float farPlane = camera.farPlane();
+
+  // Exponential slicing: slice = log(depth) * scale - bias maps [near, far] to [0, GRID_Z)
+  float logRatio = std::log(farPlane / nearPlane);
+  float scale = GRID_Z / logRatio;
+  float bias = GRID_Z * std::log(nearPlane) / logRatio;
+
+  ranges_.clear();
+  for (size_t i = directionalCount_; i < lights_.size(); i++) {
+    const auto& light = lights_[i];
+    float radius = light.direction.w;
+    glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(light.position), 1.0f));
+    float zMin = -center.z - radius;
+    float zMax = -center.z + radius;
+
+    if (zMax < nearPlane || zMin > farPlane)
+      continue;
+
+    Range range{static_cast<unsigned int>(i), 0, GRID_X - 1, 0, GRID_Y - 1,
+                slice(std::max(zMin, nearPlane), scale, bias),
+                slice(std::min(zMax, farPlane), scale, bias)};
+
+    // With the bounding box entirely in front of the near plane its projected
+    // corners bound the light on screen, otherwise keep the full tile range
+    if (zMin > nearPlane) {
+      glm::vec2 lo(INFINITY);
+      glm::vec2 hi(-INFINITY);
+      for (int corner = 0; corner < 8; corner++) {
+        glm::vec3 p = center + glm::vec3((corner & 1) ? radius : -radius,
+                                         (corner & 2) ? radius : -radius,
+                                         (corner & 4) ? radius : -radius);
+        glm::vec4 clip = projection * glm::vec4(p, 1.0f);
+        glm::vec2 ndc = glm::vec2(clip) / clip.w;
+        lo = glm::min(lo, ndc);
+        hi = glm::max(hi, ndc);
+      }
+
+      if (hi.x < -1.0f || lo.x > 1.0f || hi.y < -1.0f || lo.y > 1.0f)
+        continue;
+
+      range.x0 = std::clamp(static_cast<int>((lo.x * 0.5f + 0.5f) * GRID_X), 0, GRID_X - 1);
+      range.x1 = std::clamp(static_cast<int>((hi.x * 0.5f + 0.5f) * GRID_X), 0, GRID_X - 1);
+      range.y0 = std::clamp(static_cast<int>((lo.y * 0.5f + 0.5f) * GRID_Y), 0, GRID_Y - 1);
+      range.y1 = std::clamp(static_cast<int>((hi.y * 0.5f + 0.5f) * GRID_Y), 0, GRID_Y - 1);
+    }
+
+    ranges_.push_back(range);
+  }
+
+  // Count, prefix sum, then fill. Both passes stop at the per-cluster cap so
+  // the same lights are kept in each pass.
+  grid_.assign(CLUSTER_COUNT, glm::uvec2(0));
+  bool overflow = false;
+  for (auto& range : ranges_) {
+    for (int z = range.z0; z <= range.z1; z++)
+      for (int y = range.y0; y <= range.y1; y++)
+        for (int x = range.x0; x <= range.x1; x++) {
+          auto& cluster = grid_[x + GRID_X * (y + GRID_Y * z)];
+          if (cluster.y < MAX_LIGHTS_PER_CLUSTER)
+            cluster.y++;
+          else
+            overflow = true;
+        }
+  }
+
+  unsigned int offset = 0;
+  for (auto& cluster : grid_) {
+    cluster.x = offset;
+    offset += cluster.y;
+    cluster.y = 0;
+  }
+
+  indices_.resize(std::max(offset, 1u));
+  for (auto& range : ranges_) {
+    for (int z = range.z0; z <= range.z1; z++)
+      for (int y = range.y0; y <= range.y1; y++)
+        for (int x = range.x0; x <= range.x1; x++) {
+          auto& cluster = grid_[x + GRID_X * (y + GRID_Y * z)];
+          if (cluster.y < MAX_LIGHTS_PER_CLUSTER)
+            indices_[cluster.x + cluster.y++] = range.light;
+        }
+  }
+
+  upload(gridBuffer_, grid_.size() * sizeof(glm::uvec2), grid_.data());
+  upload(indexBuffer_, indices_.size() * sizeof(unsigned int), indices_.data());
+
+  Block block;
+  block.grid = glm::uvec4(GRID_X, GRID_Y, GRID_Z, directionalCount_);
+  block.slicing = glm::vec4(scale, bias, nearPlane, farPlane);
+  block.viewport = glm::vec4(viewport);
+  glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+  glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), nullptr, GL_DYNAMIC_DRAW);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &block);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+  glBindBufferBase(GL_UNIFORM_BUFFER, BINDING, ubo_);
+
+  GLState::bindTexture(LIGHT_DATA_UNIT, GL_TEXTURE_BUFFER, lightTexture_);
+  GLState::bindTexture(CLUSTER_GRID_UNIT, GL_TEXTURE_BUFFER, gridTexture_);
+  GLState::bindTexture(LIGHT_INDEX_UNIT, GL_TEXTURE_BUFFER, indexTexture_);
+
+  if (overflow && !overflowReported_) {
+    std::cout << "[Lights] More than " << MAX_LIGHTS_PER_CLUSTER
+              << " lights in a cluster, later lights are dropped" << std::endl;
+    overflowReported_ = true;
+  }
+}
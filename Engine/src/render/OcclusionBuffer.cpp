@@ -0,0 +1,219 @@
+#include <render/OcclusionBuffer.h>
+#include <system/WorkerPool.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OMEGA_OCCLUSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+using namespace omega::render;
+using namespace omega::geometry;
+
+auto OccluderMesh::box(const Box3<float> &box) -> std::shared_ptr<OccluderMesh> {
+  auto mesh = std::make_shared<OccluderMesh>();
+  for (unsigned int corner = 0; corner < 8; corner++) {
+	mesh->positions.emplace_back((corner & 1) ? box.maxExtents.x : box.minExtents.x,
+								 (corner & 2) ? box.maxExtents.y : box.minExtents.y,
+								 (corner & 4) ? box.maxExtents.z : box.minExtents.z);
+  }
+  // Two triangles per face, winding does not matter to the rasterizer
+  mesh->indices = {0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5,
+				   0, 4, 5, 0, 5, 1, 2, 3, 7, 2, 7, 6,
+				   0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3};
+  return mesh;
+}
+
+OcclusionBuffer::OcclusionBuffer(system::WorkerPool *workers) : workers_(workers) {
+  depth_.assign(WIDTH * HEIGHT, 1.0f);
+}
+
+auto OcclusionBuffer::begin(const glm::mat4 &viewProjection) -> void {
+  viewProjection_ = viewProjection;
+  triangles_.clear();
+  std::fill(depth_.begin(), depth_.end(), 1.0f);
+}
+
+auto OcclusionBuffer::addOccluder(const OccluderMesh &mesh, const glm::mat4 &model) -> void {
+  glm::mat4 transform = viewProjection_ * model;
+  clip_.clear();
+  for (auto &position : mesh.positions)
+	clip_.push_back(transform * glm::vec4(position, 1.0f));
+
+  for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+	const glm::vec4 *in[3] = {&clip_[mesh.indices[i]], &clip_[mesh.indices[i + 1]], &clip_[mesh.indices[i + 2]]};
+
+	// Clip against the near plane (z >= -w), one triangle becomes at most a quad
+	glm::vec4 polygon[4];
+	int count = 0;
+	for (int k = 0; k < 3; k++) {
+	  auto &from = *in[k];
+	  auto &to = *in[(k + 1) % 3];
+	  float dFrom = from.z + from.w;
+	  float dTo = to.z + to.w;
+	  if (dFrom >= 0.0f)
+		polygon[count++] = from;
+	  if ((dFrom >= 0.0f)!=(dTo >= 0.0f))
+		polygon[count++] = from + (to - from) * (dFrom / (dFrom - dTo));
+	}
+
+	for (int k = 1; k + 1 < count; k++)
+	  addTriangle(polygon[0], polygon[k], polygon[k + 1]);
+  }
+}
+
+auto OcclusionBuffer::addTriangle(const glm::vec4 &a, const glm::vec4 &b, const glm::vec4 &c) -> void {
+  glm::vec3 p[3];
+  const glm::vec4 *clip[3] = {&a, &b, &c};
+  for (int k = 0; k < 3; k++) {
+	if (clip[k]->w <= 1e-6f)
+	  return;
+	glm::vec3 ndc = glm::vec3(*clip[k]) / clip[k]->w;
+	p[k] = glm::vec3((ndc.x * 0.5f + 0.5f) * WIDTH, (ndc.y * 0.5f + 0.5f) * HEIGHT, ndc.z * 0.5f + 0.5f);
+  }
+
+  float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y);
+  if (std::abs(area) < 1e-8f)
+	return;
+  // Occluders count from both sides, turn clockwise triangles around
+  if (area < 0.0f) {
+	std::swap(p[1], p[2]);
+	area = -area;
+  }
+
+  float lowX = std::min({p[0].x, p[1].x, p[2].x});
+  float highX = std::max({p[0].x, p[1].x, p[2].x});
+  float lowY = std::min({p[0].y, p[1].y, p[2].y});
+  float highY = std::max({p[0].y, p[1].y, p[2].y});
+  if (highX < 0.0f || lowX >= WIDTH || highY < 0.0f || lowY >= HEIGHT)
+	return;
+
+  Triangle triangle;
+  triangle.x0 = static_cast<int>(std::max(lowX, 0.0f));
+  triangle.x1 = static_cast<int>(std::min(highX, WIDTH - 1.0f));
+  triangle.y0 = static_cast<int>(std::max(lowY, 0.0f));
+  triangle.y1 = static_cast<int>(std::min(highY, HEIGHT - 1.0f));
+
+  for (int k = 0; k < 3; k++) {
+	auto &from = p[k];
+	auto &to = p[(k + 1) % 3];
+	triangle.edges[k] = glm::vec3(from.y - to.y, to.x - from.x, from.x * to.y - from.y * to.x);
+  }
+
+  // Depth is linear in screen space after the divide
+  glm::vec3 u = p[1] - p[0];
+  glm::vec3 v = p[2] - p[0];
+  float dzdx = (u.z * v.y - v.z * u.y) / area;
+  float dzdy = (v.z * u.x - u.z * v.x) / area;
+  triangle.plane = glm::vec3(dzdx, dzdy, p[0].z - dzdx * p[0].x - dzdy * p[0].y);
+
+  triangles_.push_back(triangle);
+}
+
+auto OcclusionBuffer::rasterize() -> void {
+  if (triangles_.empty())
+	return;
+
+  if (workers_)
+	workers_->run(BANDS, [this](unsigned int band) { rasterizeBand(static_cast<int>(band)); });
+  else
+	for (int band = 0; band < BANDS; band++)
+	  rasterizeBand(band);
+}
+
+auto OcclusionBuffer::rasterizeBand(int band) -> void {
+  int bandLow = band * BAND_HEIGHT;
+  int bandHigh = bandLow + BAND_HEIGHT - 1;
+
+  for (auto &triangle : triangles_) {
+	int y0 = std::max(triangle.y0, bandLow);
+	int y1 = std::min(triangle.y1, bandHigh);
+	if (y0 > y1)
+	  continue;
+
+	auto &e = triangle.edges;
+	auto &z = triangle.plane;
+	int x0 = triangle.x0 & ~3;
+	for (int y = y0; y <= y1; y++) {
+	  float py = y + 0.5f;
+	  float *row = &depth_[y * WIDTH];
+#ifdef OMEGA_OCCLUSION_SSE
+	  __m128 e0 = _mm_set1_ps(e[0].y * py + e[0].z);
+	  __m128 e1 = _mm_set1_ps(e[1].y * py + e[1].z);
+	  __m128 e2 = _mm_set1_ps(e[2].y * py + e[2].z);
+	  __m128 zRow = _mm_set1_ps(z.y * py + z.z);
+	  __m128 a0 = _mm_set1_ps(e[0].x);
+	  __m128 a1 = _mm_set1_ps(e[1].x);
+	  __m128 a2 = _mm_set1_ps(e[2].x);
+	  __m128 az = _mm_set1_ps(z.x);
+	  __m128 zero = _mm_setzero_ps();
+	  for (int x = x0; x <= triangle.x1; x += 4) {
+		__m128 px = _mm_add_ps(_mm_set1_ps(float(x)), _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f));
+		__m128 inside = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), e0), zero),
+								   _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), e1), zero));
+		inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), e2), zero));
+		if (_mm_movemask_ps(inside)==0)
+		  continue;
+
+		__m128 current = _mm_loadu_ps(row + x);
+		__m128 nearest = _mm_min_ps(current, _mm_add_ps(_mm_mul_ps(az, px), zRow));
+		_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+	  }
+#else
+	  for (int x = x0; x <= triangle.x1; x++) {
+		float px = x + 0.5f;
+		if (e[0].x * px + e[0].y * py + e[0].z < 0.0f || e[1].x * px + e[1].y * py + e[1].z < 0.0f ||
+			e[2].x * px + e[2].y * py + e[2].z < 0.0f)
+		  continue;
+		row[x] = std::min(row[x], z.x * px + z.y * py + z.z);
+	  }
+#endif
+	}
+  }
+}
+
+auto OcclusionBuffer::visible(const Box3<float> &box) const -> bool {
+  glm::vec2 low(INFINITY);
+  glm::vec2 high(-INFINITY);
+  float nearest = INFINITY;
+  for (int corner = 0; corner < 8; corner++) {
+	glm::vec4 clip = viewProjection_ * glm::vec4((corner & 1) ? box.maxExtents.x : box.minExtents.x,
+												 (corner & 2) ? box.maxExtents.y : box.minExtents.y,
+												 (corner & 4) ? box.maxExtents.z : box.minExtents.z, 1.0f);
+	// Reaching past the near plane, nothing sensible to test
+	if (clip.w <= 1e-6f || clip.z < -clip.w)
+	  return true;
+
+	glm::vec3 ndc = glm::vec3(clip) / clip.w;
+	low = glm::min(low, glm::vec2(ndc));
+	high = glm::max(high, glm::vec2(ndc));
+	nearest = std::min(nearest, ndc.z * 0.5f + 0.5f);
+  }
+
+  int x0 = std::max(static_cast<int>(std::floor((low.x * 0.5f + 0.5f) * WIDTH)), 0);
+  int x1 = std::min(static_cast<int>(std::floor((high.x * 0.5f + 0.5f) * WIDTH)), WIDTH - 1);
+  int y0 = std::max(static_cast<int>(std::floor((low.y * 0.5f + 0.5f) * HEIGHT)), 0);
+  int y1 = std::min(static_cast<int>(std::floor((high.y * 0.5f + 0.5f) * HEIGHT)), HEIGHT - 1);
+  if (x0 > x1 || y0 > y1)
+	return true;
+
+  // Visible as soon as one covered pixel has nothing in front of the nearest point
+  for (int y = y0; y <= y1; y++) {
+	const float *row = &depth_[y * WIDTH];
+#ifdef OMEGA_OCCLUSION_SSE
+	__m128 boxDepth = _mm_set1_ps(nearest);
+	for (int x = x0 & ~3; x <= x1; x += 4) {
+	  if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth)))
+		return true;
+	}
+#else
+	for (int x = x0; x <= x1; x++) {
+	  if (row[x] >= nearest)
+		return true;
+	}
+#endif
+  }
+  return false;
+}
@@ -9,15 +9,29 @@ void PointLight::setup(std::shared_ptr<render::Shader> shader) {
     std::cout << "Light not used because of MAX_POINT limit" << std::endl;
     return;
   }
-  auto no = std::to_string(point_no);
-  shader->setVec3("pointLights[" + no + "].position", position_);
-  shader->setVec3("pointLights[" + no + "].ambient", ambient_);
-  shader->setVec3("pointLights[" + no + "].diffuse", diffuse_);
-  shader->setVec3("pointLights[" + no + "].specular", specular_);
-  shader->setFloat("pointLights[" + no + "].constant", constant_);
-  shader->setFloat("pointLights[" + no + "].linear", linear_);
-  shader->setFloat("pointLights[" + no + "].quadratic", quadratic_);
-  shader->setInt("pointLights[" + no + "].on", 1);
+  auto& slot = shader->pointLight(point_no);
+  shader->use();
+  shader->set(slot.position, position_);
+  shader->set(slot.ambient, ambient_);
+  shader->set(slot.diffuse, diffuse_);
+  shader->set(slot.specular, specular_);
+  shader->set(slot.constant, constant_);
+  shader->set(slot.linear, linear_);
+  shader->set(slot.quadratic, quadratic_);
+  shader->set(slot.on, 1);
+}
+
+auto PointLight::pack(interface::GpuLight& light) -> bool {
+  auto intensity = std::max({diffuse_.r, diffuse_.g, diffuse_.b,
+                             specular_.r, specular_.g, specular_.b});
+  light.position = glm::vec4(position_, float(interface::LightType::POINT));
+  light.direction = glm::vec4(0.0f, 0.0f, 0.0f,
+                              attenuationRange(constant_, linear_, quadratic_, intensity));
+  light.ambient = glm::vec4(ambient_, constant_);
+  light.diffuse = glm::vec4(diffuse_, linear_);
+  light.specular = glm::vec4(specular_, quadratic_);
+  light.cone = glm::vec4(0.0f);
+  return true;
 }
 
 void PointLight::dump() {
@@ -101,11 +101,16 @@ glm::mat4 PortalCamera::calculatePortalViewWithClipping(
     const Portal& sourcePortal,
     const Portal& destinationPortal,
     glm::vec4& clippingPlane) {
-  // Calculate clipping plane in destination portal space
-  clippingPlane = getClippingPlane(destinationPortal);
-
   // Calculate portal view
-  return calculatePortalView(playerCamera, sourcePortal, destinationPortal);
+  glm::mat4 portalView = calculatePortalView(playerCamera, sourcePortal, destinationPortal);
+
+  // Destination plane, flipped so everything on the virtual camera's side is clipped
+  clippingPlane = getClippingPlane(destinationPortal);
+  glm::vec3 cameraPos = glm::vec3(glm::inverse(portalView)[3]);
+  if (glm::dot(glm::vec3(clippingPlane), cameraPos) + clippingPlane.w > 0.0f) {
+    clippingPlane = -clippingPlane;
+  }
+  return portalView;
 }
 
 glm::vec3 PortalCamera::transformPosition(
@@ -136,14 +141,43 @@ glm::vec3 PortalCamera::transformDirection(
 }
 
 glm::vec4 PortalCamera::getClippingPlane(const Portal& portal) {
-  // Clipping plane: normal points away from portal (opposite of portal normal)
-  // This prevents seeing through the back of the portal
-  glm::vec3 normal = -portal.getNormal();  // Negative normal (points away from portal)
-  float distance = glm::dot(normal, portal.getPosition());
+  // Plane through the portal center along its normal
+  glm::vec3 normal = portal.getNormal();
+  float distance = -glm::dot(normal, portal.getPosition());
   
   return glm::vec4(normal, distance);
 }
 
+glm::mat4 PortalCamera::obliqueProjection(
+    const glm::mat4& projection,
+    const glm::mat4& view,
+    const glm::vec4& clippingPlane) {
+  // Portal plane in view space, oriented so the camera lies on its negative side
+  glm::vec4 clip = glm::transpose(glm::inverse(view)) * clippingPlane;
+  if (std::abs(clip.w) < 1e-4f) {
+    return projection;
+  }
+  if (clip.w > 0.0f) {
+    clip = -clip;
+  }
+
+  // Corner of the frustum opposite the plane, then scale the plane so it
+  // becomes the third row minus the fourth (Lengyel, "Oblique View Frustum
+  // Depth Projection and Clipping")
+  glm::vec4 q((glm::sign(clip.x) + projection[2][0]) / projection[0][0],
+              (glm::sign(clip.y) + projection[2][1]) / projection[1][1],
+              -1.0f,
+              (1.0f + projection[2][2]) / projection[3][2]);
+  glm::vec4 c = clip * (2.0f / glm::dot(clip, q));
+
+  glm::mat4 oblique = projection;
+  oblique[0][2] = c.x;
+  oblique[1][2] = c.y;
+  oblique[2][2] = c.z + 1.0f;
+  oblique[3][2] = c.w;
+  return oblique;
+}
+
 glm::mat4 PortalCamera::calculateRelativeTransform(
     const Portal& source,
     const Portal& destination) {
@@ -1,4 +1,5 @@
 #include <render/PortalFramebuffer.h>
+#include <render/GLState.h>
 #include <iostream>
 
 using namespace omega::render;
@@ -15,14 +16,14 @@ PortalFramebuffer::~PortalFramebuffer() {
 PortalFramebuffer::PortalFramebuffer(PortalFramebuffer&& other) noexcept
     : fbo_(other.fbo_),
       colorTexture_(other.colorTexture_),
-      depthTexture_(other.depthTexture_),
+      depthRenderbuffer_(other.depthRenderbuffer_),
       width_(other.width_),
       height_(other.height_),
       valid_(other.valid_) {
   // Reset other object
   other.fbo_ = 0;
   other.colorTexture_ = 0;
-  other.depthTexture_ = 0;
+  other.depthRenderbuffer_ = 0;
   other.valid_ = false;
 }
 
@@ -32,14 +33,14 @@ PortalFramebuffer& PortalFramebuffer::operator=(PortalFramebuffer&& other) noexc
 
     fbo_ = other.fbo_;
     colorTexture_ = other.colorTexture_;
-    depthTexture_ = other.depthTexture_;
+    depthRenderbuffer_ = other.depthRenderbuffer_;
     width_ = other.width_;
     height_ = other.height_;
     valid_ = other.valid_;
 
     other.fbo_ = 0;
     other.colorTexture_ = 0;
-    other.depthTexture_ = 0;
+    other.depthRenderbuffer_ = 0;
     other.valid_ = false;
   }
   return *this;
@@ -52,7 +53,7 @@ void PortalFramebuffer::createFramebuffer() {
 
   // Create color texture
   glGenTextures(1, &colorTexture_);
-  glBindTexture(GL_TEXTURE_2D, colorTexture_);
+  GLState::bindTexture(GLState::UPLOAD_UNIT, GL_TEXTURE_2D, colorTexture_);
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width_, height_, 0, GL_RGBA,
                GL_UNSIGNED_BYTE, nullptr);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -64,19 +65,14 @@ void PortalFramebuffer::createFramebuffer() {
   glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
                          colorTexture_, 0);
 
-  // Create depth texture
-  glGenTextures(1, &depthTexture_);
-  glBindTexture(GL_TEXTURE_2D, depthTexture_);
-  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, width_, height_, 0,
-               GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  // Create depth renderbuffer
+  glGenRenderbuffers(1, &depthRenderbuffer_);
+  glBindRenderbuffer(GL_RENDERBUFFER, depthRenderbuffer_);
+  glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width_, height_);
 
-  // Attach depth texture to framebuffer
-  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
-                         depthTexture_, 0);
+  // Attach depth renderbuffer to framebuffer
+  glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER,
+                            depthRenderbuffer_);
 
   // Check framebuffer completeness
   valid_ = (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
@@ -90,7 +86,8 @@ void PortalFramebuffer::createFramebuffer() {
 
   // Unbind framebuffer
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
-  glBindTexture(GL_TEXTURE_2D, 0);
+  GLState::bindTexture(GLState::UPLOAD_UNIT, GL_TEXTURE_2D, 0);
+  glBindRenderbuffer(GL_RENDERBUFFER, 0);
 }
 
 void PortalFramebuffer::destroyFramebuffer() {
@@ -99,12 +96,13 @@ void PortalFramebuffer::destroyFramebuffer() {
     fbo_ = 0;
   }
   if (colorTexture_ != 0) {
+    GLState::forgetTexture(colorTexture_);
     glDeleteTextures(1, &colorTexture_);
     colorTexture_ = 0;
   }
-  if (depthTexture_ != 0) {
-    glDeleteTextures(1, &depthTexture_);
-    depthTexture_ = 0;
+  if (depthRenderbuffer_ != 0) {
+    glDeleteRenderbuffers(1, &depthRenderbuffer_);
+    depthRenderbuffer_ = 0;
   }
   valid_ = false;
 }
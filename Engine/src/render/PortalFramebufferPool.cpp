@@ -0,0 +1,61 @@
+#include <render/PortalFramebufferPool.h>
+
+#include <algorithm>
+
+using namespace omega::render;
+
+glm::ivec2 PortalFramebufferPool::bucket(const glm::ivec2& size) {
+  auto round = [](int extent) {
+    int bucket = MIN_SIZE;
+    while (bucket < extent)
+      bucket *= 2;
+    return bucket;
+  };
+  return glm::ivec2(round(size.x), round(size.y));
+}
+
+PortalFramebuffer* PortalFramebufferPool::acquire(const glm::ivec2& size, bool persistent) {
+  glm::ivec2 extent = bucket(size);
+  for (auto& target : targets_) {
+    if (!target.used && target.framebuffer->getWidth() == extent.x &&
+        target.framebuffer->getHeight() == extent.y) {
+      target.used = true;
+      target.persistent = persistent;
+      target.idleFrames = 0;
+      return target.framebuffer.get();
+    }
+  }
+
+  Target target;
+  target.framebuffer = std::make_unique<PortalFramebuffer>(extent.x, extent.y);
+  target.used = true;
+  target.persistent = persistent;
+  targets_.push_back(std::move(target));
+  return targets_.back().framebuffer.get();
+}
+
+void PortalFramebufferPool::release(PortalFramebuffer* framebuffer) {
+  for (auto& target : targets_) {
+    if (target.framebuffer.get() == framebuffer) {
+      target.used = false;
+      target.persistent = false;
+      return;
+    }
+  }
+}
+
+void PortalFramebufferPool::reclaim() {
+  // Frames since a target was last acquired, persistent ones stay in use
+  for (auto& target : targets_) {
+    if (target.persistent) {
+      target.idleFrames = 0;
+      continue;
+    }
+    target.idleFrames++;
+    target.used = false;
+  }
+
+  targets_.erase(std::remove_if(targets_.begin(), targets_.end(),
+                                [](const Target& target) { return target.idleFrames > IDLE_FRAMES; }),
+                 targets_.end());
+}
@@ -20,6 +20,11 @@ PortalViewCamera::PortalViewCamera(std::shared_ptr<Camera> baseCamera,
   // Copy projection matrix from base camera (will be overridden if framebuffer aspect differs)
   if (baseCamera_) {
     projection_matrix_ = baseCamera_->projectionMatrix();
+    // An oblique base projection is no starting point for another one
+    auto basePortalView = std::dynamic_pointer_cast<PortalViewCamera>(baseCamera_);
+    unclippedProjection_ = basePortalView ? basePortalView->unclippedProjection() : projection_matrix_;
+    near_ = baseCamera_->nearPlane();
+    far_ = baseCamera_->farPlane();
   }
 }
 
@@ -27,9 +32,29 @@ glm::mat4 PortalViewCamera::viewMatrix() const {
   return customView_;
 }
 
+glm::mat4 PortalViewCamera::narrowing(const glm::vec4& rect) {
+  glm::vec2 size = glm::vec2(rect.z - rect.x, rect.w - rect.y);
+  glm::vec2 center = glm::vec2(rect.x + rect.z, rect.y + rect.w) - 1.0f;
+  glm::mat4 narrow(1.0f);
+  narrow[0][0] = 2.0f / size.x;
+  narrow[1][1] = 2.0f / size.y;
+  narrow[3][0] = -center.x * narrow[0][0];
+  narrow[3][1] = -center.y * narrow[1][1];
+  return narrow;
+}
+
+glm::mat4x4 PortalViewCamera::cullingProjection() {
+  // With the rectangle filling clip space the side planes pass through the
+  // camera and the portal's screen edges
+  return narrowing(screenRect_) * projection_matrix_;
+}
+
 glm::mat4x4 PortalViewCamera::projectionMatrix() {
-  // Always return the stored projection matrix
-  // This allows PortalRenderer to override it with framebuffer-specific aspect ratio
+  // Return the stored projection matrix, stretched over the target when
+  // only the portal's rectangle is rendered
+  if (fitRect_) {
+    return narrowing(screenRect_) * projection_matrix_;
+  }
   return projection_matrix_;
 }
 
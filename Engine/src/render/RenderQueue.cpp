@@ -0,0 +1,58 @@
+#include <render/RenderQueue.h>
+
+#include <algorithm>
+#include <array>
+
+using namespace omega::render;
+
+auto RenderQueue::key(uint32_t pass, uint32_t program, uint32_t textureSet, uint32_t vao, uint32_t lod,
+                      float depth) -> uint64_t {
+  constexpr uint32_t depthMax = (1u << DEPTH_BITS) - 1;
+  auto field = [](uint32_t value, int bits) { return static_cast<uint64_t>(value & ((1u << bits) - 1)); };
+  auto quantized = static_cast<uint32_t>(std::clamp(depth, 0.0f, 1.0f) * depthMax);
+
+  uint64_t key = field(pass, PASS_BITS);
+  if (pass == BLENDED)
+    key = (key << DEPTH_BITS) | (depthMax - quantized);
+  key = (key << PROGRAM_BITS) | field(program, PROGRAM_BITS);
+  key = (key << TEXTURE_BITS) | field(textureSet, TEXTURE_BITS);
+  key = (key << VAO_BITS) | field(vao, VAO_BITS);
+  key = (key << LOD_BITS) | field(lod, LOD_BITS);
+  if (pass != BLENDED)
+    key = (key << DEPTH_BITS) | quantized;
+  return key;
+}
+
+void RenderQueue::sort() {
+  constexpr int DIGITS = 8;
+  constexpr int RADIX = 256;
+
+  if (items_.size() < 2)
+    return;
+
+  // One pass gathers the histograms of all eight digits
+  std::array<std::array<uint32_t, RADIX>, DIGITS> counts{};
+  for (auto& item : items_)
+    for (int digit = 0; digit < DIGITS; digit++)
+      counts[digit][(item.key >> (digit * 8)) & 0xFF]++;
+
+  scratch_.resize(items_.size());
+  for (int digit = 0; digit < DIGITS; digit++) {
+    auto& count = counts[digit];
+
+    // Every key has the same digit here, the order would not change
+    if (count[(items_.front().key >> (digit * 8)) & 0xFF] == items_.size())
+      continue;
+
+    uint32_t offset = 0;
+    for (auto& bucket : count) {
+      uint32_t n = bucket;
+      bucket = offset;
+      offset += n;
+    }
+
+    for (auto& item : items_)
+      scratch_[count[(item.key >> (digit * 8)) & 0xFF]++] = item;
+    items_.swap(scratch_);
+  }
+}
@@ -1,8 +1,14 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <algorithm>
+#include <vector>
 
 #include <render/Shader.h>
+#include <render/FrameData.h>
+#include <render/LightClusters.h>
+#include <render/InstanceBuffer.h>
+#include <render/GLState.h>
 #include <system/FileSystem.h>
 
 #if defined(WIN32)
@@ -21,10 +27,6 @@
 using namespace omega::render;
 using namespace omega::geometry;
 
-#define MAX_POINT 4
-#define MAX_SPOT 4
-#define MAX_DIRECTIONAL 4
-
 std::string Shader::loadShaderSource(const std::string& fileName) {
   std::string temp = "";
   std::string src = "";
@@ -85,23 +87,21 @@ GLuint Shader::loadShaderFromString(GLenum type, const std::string& str_src) {
   return shader;
 }
 
-void Shader::linkProgram(GLuint vertexShader, GLuint geometryShader,
-						 GLuint fragmentShader) {
+void Shader::linkProgram(std::initializer_list<unsigned int> shaders) {
   char infoLog[512];
   GLint success;
 
   this->id = glCreateProgram();
 
-  glAttachShader(this->id, vertexShader);
-
-  if (geometryShader)
-	glAttachShader(this->id, geometryShader);
-
-  glAttachShader(this->id, fragmentShader);
+  for (auto shader : shaders) {
+	if (shader)
+	  glAttachShader(this->id, shader);
+  }
 
   glLinkProgram(this->id);
 
   glGetProgramiv(this->id, GL_LINK_STATUS, &success);
+  linked_ = success;
   if (!success) {
 	glGetProgramInfoLog(this->id, 512, NULL, infoLog);
 	std::cout << "ERROR::SHADER::COULD_NOT_LINK_PROGRAM"
@@ -109,7 +109,127 @@ void Shader::linkProgram(GLuint vertexShader, GLuint geometryShader,
 	std::cout << infoLog << "\n";
   }
 
-  glUseProgram(0);
+  this->reflectUniforms();
+
+  GLState::useProgram(0);
+}
+
+void Shader::reflectUniforms() {
+  uniforms_.clear();
+
+  GLint count = 0;
+  GLint maxLength = 0;
+  glGetProgramiv(this->id, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(this->id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+  std::vector<GLchar> buffer(std::max(maxLength, 1));
+  for (GLint index = 0; index < count; index++) {
+	GLsizei length = 0;
+	GLint size = 0;
+	GLenum type = 0;
+	glGetActiveUniform(this->id, index, static_cast<GLsizei>(buffer.size()), &length,
+					   &size, &type, buffer.data());
+
+	std::string name(buffer.data(), length);
+	GLint location = glGetUniformLocation(this->id, name.c_str());
+	if (location < 0)
+	  continue; // Members of uniform blocks have no location
+
+	uniforms_[name] = location;
+
+	// Arrays of basic types are reported once as "name[0]", register the
+	// bare name and every element so lookups match glGetUniformLocation
+	auto pos = name.rfind("[0]");
+	if (pos != std::string::npos && pos + 3 == name.size()) {
+	  auto base = name.substr(0, pos);
+	  uniforms_[base] = location;
+	  for (GLint element = 1; element < size; element++) {
+		auto elementName = base + "[" + std::to_string(element) + "]";
+		uniforms_[elementName] = glGetUniformLocation(this->id, elementName.c_str());
+	  }
+	}
+  }
+
+  // Attach the shared per-view block when the program declares it
+  frame_data_ = false;
+  GLuint blockIndex = glGetUniformBlockIndex(this->id, FrameData::BLOCK_NAME);
+  if (blockIndex != GL_INVALID_INDEX) {
+	glUniformBlockBinding(this->id, blockIndex, FrameData::BINDING);
+	frame_data_ = true;
+  }
+
+  // Clustered lighting reads its own block and three texture buffers on fixed units
+  clustered_lights_ = false;
+  blockIndex = glGetUniformBlockIndex(this->id, LightClusters::BLOCK_NAME);
+  if (blockIndex != GL_INVALID_INDEX) {
+	glUniformBlockBinding(this->id, blockIndex, LightClusters::BINDING);
+	GLState::useProgram(this->id);
+	set(uniform("lightData"), LightClusters::LIGHT_DATA_UNIT);
+	set(uniform("clusterGrid"), LightClusters::CLUSTER_GRID_UNIT);
+	set(uniform("lightIndices"), LightClusters::LIGHT_INDEX_UNIT);
+	clustered_lights_ = true;
+  }
+
+  // Instanced draws fetch model matrices from the instance buffer
+  auto instanceData = uniform("instanceData");
+  instancing_ = instanceData.valid();
+  if (instancing_) {
+	GLState::useProgram(this->id);
+	set(instanceData, InstanceBuffer::INSTANCE_DATA_UNIT);
+  }
+
+  object_uniforms_.projection = uniform("projection");
+  object_uniforms_.view = uniform("view");
+  object_uniforms_.model = uniform("model");
+  object_uniforms_.viewPos = uniform("viewPos");
+  object_uniforms_.shininess = uniform("material.shininess");
+  object_uniforms_.instanced = uniform("instanced");
+  object_uniforms_.instanceBase = uniform("instanceBase");
+  object_uniforms_.batched = uniform("batched");
+  object_uniforms_.transparency = uniform("transparency");
+  object_uniforms_.compactNormals = uniform("compactNormals");
+
+  point_light_uniforms_.resize(MAX_POINT);
+  for (int no = 0; no < MAX_POINT; no++) {
+	auto prefix = "pointLights[" + std::to_string(no) + "].";
+	auto& slot = point_light_uniforms_[no];
+	slot.position = uniform(prefix + "position");
+	slot.ambient = uniform(prefix + "ambient");
+	slot.diffuse = uniform(prefix + "diffuse");
+	slot.specular = uniform(prefix + "specular");
+	slot.constant = uniform(prefix + "constant");
+	slot.linear = uniform(prefix + "linear");
+	slot.quadratic = uniform(prefix + "quadratic");
+	slot.on = uniform(prefix + "on");
+  }
+
+  spot_light_uniforms_.resize(MAX_SPOT);
+  for (int no = 0; no < MAX_SPOT; no++) {
+	auto prefix = "spotLight[" + std::to_string(no) + "].";
+	auto& slot = spot_light_uniforms_[no];
+	slot.position = uniform(prefix + "position");
+	slot.direction = uniform(prefix + "direction");
+	slot.ambient = uniform(prefix + "ambient");
+	slot.diffuse = uniform(prefix + "diffuse");
+	slot.specular = uniform(prefix + "specular");
+	slot.constant = uniform(prefix + "constant");
+	slot.linear = uniform(prefix + "linear");
+	slot.quadratic = uniform(prefix + "quadratic");
+	slot.cutOff = uniform(prefix + "cutOff");
+	slot.outerCutOff = uniform(prefix + "outerCutOff");
+	slot.on = uniform(prefix + "on");
+  }
+
+  dir_light_uniforms_.resize(MAX_DIRECTIONAL);
+  for (int no = 0; no < MAX_DIRECTIONAL; no++) {
+	auto prefix = "dirLight[" + std::to_string(no) + "].";
+	auto& slot = dir_light_uniforms_[no];
+	slot.direction = uniform(prefix + "direction");
+	slot.ambient = uniform(prefix + "ambient");
+	slot.diffuse = uniform(prefix + "diffuse");
+	slot.specular = uniform(prefix + "specular");
+	slot.on = uniform(prefix + "on");
+  }
 }
 
 // Constructors/Destructors
@@ -128,7 +248,7 @@ Shader::Shader(const int versionMajor, const int versionMinor,
 
   fragmentShader = loadShaderFromFile(GL_FRAGMENT_SHADER, fragmentFile);
 
-  this->linkProgram(vertexShader, geometryShader, fragmentShader);
+  this->linkProgram({vertexShader, geometryShader, fragmentShader});
 
   // End
   glDeleteShader(vertexShader);
@@ -143,6 +263,7 @@ Shader::Shader(const int versionMajor, const int versionMinor)
 
 Shader::~Shader() { 
   if (id != 0) {
+	GLState::forgetProgram(this->id);
 	glDeleteProgram(this->id);
   }
 }
@@ -161,7 +282,7 @@ bool Shader::loadShadersFromString(const std::string& vertexCode,
 
   fragmentShader = loadShaderFromString(GL_FRAGMENT_SHADER, fragmentCode);
 
-  this->linkProgram(vertexShader, geometryShader, fragmentShader);
+  this->linkProgram({vertexShader, geometryShader, fragmentShader});
 
   // End
   glDeleteShader(vertexShader);
@@ -184,7 +305,7 @@ bool Shader::loadShadersFromFile(const std::string& vertexFile,
 
   fragmentShader = loadShaderFromFile(GL_FRAGMENT_SHADER, fragmentFile);
 
-  this->linkProgram(vertexShader, geometryShader, fragmentShader);
+  this->linkProgram({vertexShader, geometryShader, fragmentShader});
 
   // End
   glDeleteShader(vertexShader);
@@ -194,58 +315,76 @@ bool Shader::loadShadersFromFile(const std::string& vertexFile,
 }
 
 // Set uniform functions
-void Shader::use() { glUseProgram(this->id); }
+void Shader::use() { GLState::useProgram(this->id); }
 
-void Shader::unuse() { glUseProgram(0); }
+void Shader::unuse() { GLState::useProgram(0); }
 
-void Shader::setInt(const std::string& name, GLint value) {
-  this->use();
+auto Shader::uniform(const std::string& name) const -> UniformHandle {
+  auto it = uniforms_.find(name);
+  if (it == uniforms_.end())
+	return {};
+  return {it->second};
+}
 
-  glUniform1i(glGetUniformLocation(this->id, name.c_str()), value);
+void Shader::set(UniformHandle handle, GLint value) {
+  if (handle.valid())
+	glUniform1i(handle.location, value);
+}
 
-  this->unuse();
+void Shader::set(UniformHandle handle, GLfloat value) {
+  if (handle.valid())
+	glUniform1f(handle.location, value);
 }
 
-void Shader::setFloat(const std::string& name, GLfloat value) {
-  this->use();
+void Shader::set(UniformHandle handle, const glm::vec2& value) {
+  if (handle.valid())
+	glUniform2fv(handle.location, 1, &value[0]);
+}
 
-  glUniform1f(glGetUniformLocation(this->id, name.c_str()), value);
+void Shader::set(UniformHandle handle, const glm::vec3& value) {
+  if (handle.valid())
+	glUniform3fv(handle.location, 1, &value[0]);
+}
 
-  this->unuse();
+void Shader::set(UniformHandle handle, const glm::vec4& value) {
+  if (handle.valid())
+	glUniform4fv(handle.location, 1, &value[0]);
 }
 
-void Shader::setVec2(const std::string& name, glm::vec2 value) {
+void Shader::set(UniformHandle handle, const glm::mat4& value) {
+  if (handle.valid())
+	glUniformMatrix4fv(handle.location, 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::setInt(const std::string& name, GLint value) {
   this->use();
+  set(uniform(name), value);
+}
 
-  glUniform2fv(glGetUniformLocation(this->id, name.c_str()), 1, &value[0]);
+void Shader::setFloat(const std::string& name, GLfloat value) {
+  this->use();
+  set(uniform(name), value);
+}
 
-  this->unuse();
+void Shader::setVec2(const std::string& name, glm::vec2 value) {
+  this->use();
+  set(uniform(name), value);
 }
 
 void Shader::setVec3(const std::string& name, glm::vec3 value) {
   this->use();
-
-  glUniform3fv(glGetUniformLocation(this->id, name.c_str()), 1, &value[0]);
-
-  this->unuse();
+  set(uniform(name), value);
 }
 
 void Shader::setVec4(const std::string& name, glm::vec4 value) {
   this->use();
-
-  glUniform4fv(glGetUniformLocation(this->id, name.c_str()), 1, &value[0]);
-
-  this->unuse();
+  set(uniform(name), value);
 }
 
 void Shader::setMat4fv(const std::string& name, glm::mat4 value,
 					   bool transpose) {
   this->use();
-
-  glUniformMatrix4fv(glGetUniformLocation(this->id, name.c_str()), 1, GL_FALSE,
-					 &value[0][0]);
-
-  this->unuse();
+  set(uniform(name), value);
 }
 
 void Shader::setVec3(const std::string& name, float x, float y, float z) {
@@ -268,6 +407,15 @@ std::shared_ptr<Shader> Shader::fromString(const int versionMajor,
   return ptr;
 }
 
+bool Shader::loadComputeFromFile(const std::string& computeFile) {
+  GLuint computeShader = loadShaderFromFile(GL_COMPUTE_SHADER, computeFile);
+
+  this->linkProgram({computeShader});
+
+  glDeleteShader(computeShader);
+  return linked_;
+}
+
 std::shared_ptr<Shader> Shader::fromFile(const int versionMajor,
 										 const int versionMinor,
 										 const std::string& vertexFile,
@@ -299,10 +447,21 @@ auto Shader::getLightNumber(interface::LightType type) -> int {
 }
 
 auto Shader::turnOffLights() -> void {
-  for (int no = 0; no < MAX_SPOT; no++)
-	setInt("spotLight[" + std::to_string(no) + "].on", 0);
-  for (int no = 0; no < MAX_POINT; no++)
-	setInt("pointLights[" + std::to_string(no) + "].on", 0);
-  for (int no = 0; no < MAX_DIRECTIONAL; no++)
-	setInt("dirLight[" + std::to_string(no) + "].on", 0);
+  this->use();
+  for (auto& slot : spot_light_uniforms_)
+	set(slot.on, 0);
+  for (auto& slot : point_light_uniforms_)
+	set(slot.on, 0);
+  for (auto& slot : dir_light_uniforms_)
+	set(slot.on, 0);
+}
+
+std::shared_ptr<Shader> Shader::computeFromFile(const int versionMajor,
+												const int versionMinor,
+												const std::string& computeFile) {
+  auto ptr = std::make_shared<Shader>(versionMajor, versionMinor);
+
+  ptr->loadComputeFromFile(computeFile);
+
+  return ptr;
 }
@@ -10,24 +10,52 @@ void SpotLight::setup(std::shared_ptr<render::Shader> shader) {
     std::cout << "Light not used because of MAX_POINT limit" << std::endl;
     return;
   }
-  auto no = std::to_string(point_no);
+  auto& slot = shader->spotLight(point_no);
 
   if (tracking_) {
     position_ = tracking_->get()->entityPosition();
     direction_ = tracking_->get()->entityDirection();
   }
 
-  shader->setVec3("spotLight[" + no + "].position", position_);
-  shader->setVec3("spotLight[" + no + "].direction", direction_);
-  shader->setVec3("spotLight[" + no + "].ambient", ambient_);
-  shader->setVec3("spotLight[" + no + "].diffuse", diffuse_);
-  shader->setVec3("spotLight[" + no + "].specular", specular_);
-  shader->setFloat("spotLight[" + no + "].constant", constant_);
-  shader->setFloat("spotLight[" + no + "].linear", linear_);
-  shader->setFloat("spotLight[" + no + "].quadratic", quadratic_);
-  shader->setFloat("spotLight[" + no + "].cutOff", cutOff_);
-  shader->setFloat("spotLight[" + no + "].outerCutOff", outerCutOff_);
-  shader->setInt("spotLight[" + no + "].on", 1);
+  shader->use();
+  shader->set(slot.position, position_);
+  shader->set(slot.direction, direction_);
+  shader->set(slot.ambient, ambient_);
+  shader->set(slot.diffuse, diffuse_);
+  shader->set(slot.specular, specular_);
+  shader->set(slot.constant, constant_);
+  shader->set(slot.linear, linear_);
+  shader->set(slot.quadratic, quadratic_);
+  shader->set(slot.cutOff, cutOff_);
+  shader->set(slot.outerCutOff, outerCutOff_);
+  shader->set(slot.on, 1);
+}
+
+auto SpotLight::pack(interface::GpuLight& light) -> bool {
+  if (tracking_) {
+    position_ = tracking_->get()->entityPosition();
+    direction_ = tracking_->get()->entityDirection();
+  }
+
+  auto intensity = std::max({diffuse_.r, diffuse_.g, diffuse_.b,
+                             specular_.r, specular_.g, specular_.b});
+  light.position = glm::vec4(position_, float(interface::LightType::SPOT));
+  light.direction = glm::vec4(direction_,
+                              attenuationRange(constant_, linear_, quadratic_, intensity));
+  light.ambient = glm::vec4(ambient_, constant_);
+  light.diffuse = glm::vec4(diffuse_, linear_);
+  light.specular = glm::vec4(specular_, quadratic_);
+  light.cone = glm::vec4(cutOff_, outerCutOff_, 0.0f, 0.0f);
+  packedPosition_ = position_;
+  packedDirection_ = direction_;
+  return true;
+}
+
+auto SpotLight::changed() -> bool {
+  if (!tracking_)
+    return false;
+  return tracking_->get()->entityPosition() != packedPosition_ ||
+         tracking_->get()->entityDirection() != packedDirection_;
 }
 
 void SpotLight::dump() {
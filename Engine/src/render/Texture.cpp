@@ -1,5 +1,6 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <render/Texture.h>
+#include <render/GLState.h>
 #include <system/FileSystem.h>
 
 #include <stb_image.h>
@@ -23,7 +24,7 @@ auto Texture::loadImageData(const std::string& fileName, bool flip, const std::s
 
 bool Texture::load(const std::string& fileName, const std::string& name) {
   glGenTextures(1, &m_textureId);
-  glBindTexture(GL_TEXTURE_2D, m_textureId);
+  GLState::bindTexture(GLState::UPLOAD_UNIT, GL_TEXTURE_2D, m_textureId);
   // set the texture wrapping parameters
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
@@ -57,7 +58,6 @@ bool Texture::load(const std::string& fileName, const std::string& name) {
 
 bool Texture::activate(int no) {
   // bind textures on corresponding texture units
-  glActiveTexture(GL_TEXTURE0 + no);
-  glBindTexture(GL_TEXTURE_2D, m_textureId);
+  GLState::bindTexture(no, GL_TEXTURE_2D, m_textureId);
   return true;
 }
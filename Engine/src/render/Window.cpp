@@ -267,7 +267,7 @@ bool Window::isRuning() { return not m_quit; }
 
 void Window::clear() {
   glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 }
 
 bool Window::render() { return true; }
@@ -405,6 +405,8 @@ bool Window::initGL() {
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
   glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE);
   glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+  // Stencil portals mark their pixels with one value per recursion depth
+  glfwWindowHint(GLFW_STENCIL_BITS, 8);
   m_window = glfwCreateWindow(m_width, m_height, "Open GL", NULL, NULL);
   if (!m_window) {
 	std::cout
@@ -442,7 +444,7 @@ bool Window::initGL() {
 
   glEnable(GL_DEPTH_TEST);
   glEnable(GL_CULL_FACE);
-  glEnable(GL_BLEND);
+  // Blending stays off, the scene enables it for its blended pass only
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
   return success;
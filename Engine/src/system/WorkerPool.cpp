@@ -0,0 +1,68 @@
+#include <system/WorkerPool.h>
+
+#include <algorithm>
+
+using namespace omega::system;
+
+WorkerPool::WorkerPool(unsigned int threads) {
+  if (threads==0)
+	threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+  for (unsigned int i = 0; i < threads; i++)
+	workers_.emplace_back([this] { work(); });
+}
+
+WorkerPool::~WorkerPool() {
+  {
+	std::lock_guard<std::mutex> lock(mutex_);
+	stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto &worker : workers_)
+	worker.join();
+}
+
+auto WorkerPool::run(unsigned int count, const std::function<void(unsigned int)> &task) -> void {
+  if (workers_.empty() || count < 2) {
+	for (unsigned int i = 0; i < count; i++)
+	  task(i);
+	return;
+  }
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  task_ = &task;
+  count_ = count;
+  next_ = 0;
+  remaining_ = count;
+  wake_.notify_all();
+
+  while (next_ < count_) {
+	auto index = next_++;
+	lock.unlock();
+	task(index);
+	lock.lock();
+	remaining_--;
+  }
+
+  done_.wait(lock, [this] { return remaining_==0; });
+  task_ = nullptr;
+  count_ = 0;
+  next_ = 0;
+}
+
+auto WorkerPool::work() -> void {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+	wake_.wait(lock, [this] { return stop_ || next_ < count_; });
+	if (stop_)
+	  return;
+
+	auto index = next_++;
+	auto *task = task_;
+	lock.unlock();
+	(*task)(index);
+	lock.lock();
+	if (--remaining_==0)
+	  done_.notify_all();
+  }
+}
@@ -2,6 +2,8 @@
 #include <system/FileSystem.h>
 #include <geometry/Object.h>
 #include <utils/ObjectGenerator.h>
+#include <utils/MeshOptimizer.h>
+#include <utils/MeshSimplifier.h>
 #include <render/Texture.h>
 
 #include <glm/glm.hpp>
@@ -22,7 +24,7 @@ using namespace omega::render;
 using namespace omega::geometry;
 using namespace std;
 
-auto Loader::loadModel(std::string path) -> ObjectNodePtr {
+auto Loader::loadModel(std::string path, unsigned int flags) -> ObjectNodePtr {
   auto bytes = fs::instance()->data(path);
   auto ext = fs::instance()->extension(path);
   auto tree = std::make_shared<ObjectNode>();
@@ -46,17 +48,17 @@ auto Loader::loadModel(std::string path) -> ObjectNodePtr {
   }
 
 // process ASSIMP's root node recursively
-  tree = processNode(scene->mRootNode, scene);
+  tree = processNode(scene->mRootNode, scene, flags);
 
   return tree;
 }
 
-auto Loader::processNode(aiNode *node, const aiScene *scene) -> ObjectNodePtr {
+auto Loader::processNode(aiNode *node, const aiScene *scene, unsigned int flags) -> ObjectNodePtr {
   auto tree = std::make_shared<ObjectNode>();
 
   // process each mesh located at the current node
   glm::mat4x4 mat(node->mTransformation.a1, node->mTransformation.b1,
-				  node->mTransformation.c3, node->mTransformation.d1,
+				  node->mTransformation.c1, node->mTransformation.d1,
 				  node->mTransformation.a2, node->mTransformation.b2,
 				  node->mTransformation.c2, node->mTransformation.d2,
 				  node->mTransformation.a3, node->mTransformation.b3,
@@ -71,23 +73,23 @@ auto Loader::processNode(aiNode *node, const aiScene *scene) -> ObjectNodePtr {
 	// the scene. the scene contains all the data, node is just to keep
 	// stuff organized (like relations between nodes).
 	aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-	auto object = processMesh(node->mName.C_Str(), mesh, scene);
+	auto object = processMesh(node->mName.C_Str(), mesh, scene, flags);
 	if (object)
 	  tree->meshes.push_back(object);
   }
   // after we've processed all of the meshes (if any) we then recursively
   // process each of the children nodes
   for (unsigned int i = 0; i < node->mNumChildren; i++) {
-	auto child = processNode(node->mChildren[i], scene);
+	auto child = processNode(node->mChildren[i], scene, flags);
 	tree->children.push_back(child);
   }
   return tree;
 }
 
 shared_ptr<Object> Loader::processMesh(std::string name, aiMesh *mesh,
-									   const aiScene *scene) {
+									   const aiScene *scene, unsigned int flags) {
 
-  float minx, miny, minz, maxx, maxy, maxz;
+  float minx = 0, miny = 0, minz = 0, maxx = 0, maxy = 0, maxz = 0;
   // data to fill
   vector<Vertex> vertices;
   vector<unsigned int> indices;
@@ -161,6 +163,10 @@ shared_ptr<Object> Loader::processMesh(std::string name, aiMesh *mesh,
 	for (unsigned int j = 0; j < face.mNumIndices; j++)
 	  indices.push_back(face.mIndices[j]);
   }
+  // weld and reorder for the post-transform cache, overdraw and vertex fetch
+  MeshOptimizer::optimize(vertices, indices, name);
+  auto lods = MeshSimplifier::buildLods(vertices, indices);
+
   // process materials
   aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
   // we assume a convention for sampler names in the shaders. Each diffuse
@@ -181,6 +187,8 @@ shared_ptr<Object> Loader::processMesh(std::string name, aiMesh *mesh,
   // 3. normal maps
   auto normalMaps =
 	  loadMaterialTextures(material, aiTextureType_HEIGHT, "texture_normal");
+  if (!normalMaps.empty() && mesh->HasTangentsAndBitangents())
+	flags |= ogNormalMap;
   textures.merge(normalMaps);
   // 4. height maps
   auto heightMaps =
@@ -190,8 +198,19 @@ shared_ptr<Object> Loader::processMesh(std::string name, aiMesh *mesh,
   // return a mesh object created from the extracted mesh data
   auto object = utils::ObjectGenerator::mesh({.vertices = vertices,
 												 .indices = indices,
+												 .lods = std::move(lods),
 												 .textures = textures,
-												 .name = name});
+												 .name = name,
+												 .flags = flags,
+												 .bounds = Box3<float>(minx, miny, minz, maxx, maxy, maxz)});
+
+  // Translucent materials go to the blended pass
+  float opacity = 1.0f;
+  if (material->Get(AI_MATKEY_OPACITY, opacity)==AI_SUCCESS && opacity < 1.0f) {
+	Material translucent;
+	translucent.opacity = opacity;
+	object->setMaterial(translucent);
+  }
 
   return object;
 }
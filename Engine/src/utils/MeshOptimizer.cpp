@@ -0,0 +1,290 @@
+#include <utils/MeshOptimizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+using namespace omega::utils;
+using namespace omega::geometry;
+
+namespace {
+
+// Forsyth's scoring, the cache here is only a model of recent use
+constexpr int SCORE_CACHE_SIZE = 32;
+constexpr float CACHE_DECAY_POWER = 1.5f;
+constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float VALENCE_BOOST_SCALE = 2.0f;
+constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+auto vertexScore(int cachePosition, unsigned int remaining) -> float {
+  if (remaining == 0)
+	return -1.0f;
+
+  float score = 0.0f;
+  if (cachePosition >= 0) {
+	if (cachePosition < 3)
+	  score = LAST_TRIANGLE_SCORE;
+	else
+	  score = std::pow(1.0f - float(cachePosition - 3) / (SCORE_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+  }
+  return score + VALENCE_BOOST_SCALE * std::pow(float(remaining), -VALENCE_BOOST_POWER);
+}
+
+struct VertexHash {
+  auto operator()(const Vertex &vertex) const -> size_t {
+	// FNV-1a over the raw bytes, welding is bitwise
+	auto *bytes = reinterpret_cast<const unsigned char *>(&vertex);
+	size_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < sizeof(Vertex); i++)
+	  hash = (hash ^ bytes[i]) * 1099511628211ull;
+	return hash;
+  }
+};
+
+struct VertexEqual {
+  auto operator()(const Vertex &a, const Vertex &b) const -> bool {
+	return std::memcmp(&a, &b, sizeof(Vertex)) == 0;
+  }
+};
+
+}  // namespace
+
+auto MeshOptimizer::analyze(const std::vector<unsigned int> &indices, size_t vertexCount) -> MeshStats {
+  if (indices.empty() || vertexCount == 0)
+	return {};
+
+  std::vector<unsigned int> stamp(vertexCount, 0);
+  unsigned int time = CACHE_SIZE + 1;
+  unsigned int misses = 0;
+
+  // A FIFO cache: a vertex is cached while fewer than CACHE_SIZE misses happened since it entered
+  for (auto index : indices) {
+	if (time - stamp[index] > CACHE_SIZE) {
+	  stamp[index] = time++;
+	  misses++;
+	}
+  }
+
+  return {float(misses) / float(indices.size() / 3), float(misses) / float(vertexCount)};
+}
+
+auto MeshOptimizer::weld(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices) -> void {
+  std::unordered_map<Vertex, unsigned int, VertexHash, VertexEqual> unique;
+  unique.reserve(vertices.size());
+
+  std::vector<unsigned int> remap(vertices.size());
+  std::vector<Vertex> welded;
+  welded.reserve(vertices.size());
+  for (size_t i = 0; i < vertices.size(); i++) {
+	auto [it, inserted] = unique.emplace(vertices[i], static_cast<unsigned int>(welded.size()));
+	if (inserted)
+	  welded.push_back(vertices[i]);
+	remap[i] = it->second;
+  }
+
+  for (auto &index : indices)
+	index = remap[index];
+  vertices.swap(welded);
+}
+
+auto MeshOptimizer::optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount) -> void {
+  size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0)
+	return;
+
+  // Triangles using each vertex, as offsets into one shared list
+  std::vector<unsigned int> remaining(vertexCount, 0);
+  for (auto index : indices)
+	remaining[index]++;
+
+  std::vector<unsigned int> offsets(vertexCount + 1, 0);
+  for (size_t v = 0; v < vertexCount; v++)
+	offsets[v + 1] = offsets[v] + remaining[v];
+
+  std::vector<unsigned int> adjacency(indices.size());
+  std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t t = 0; t < triangleCount; t++)
+	for (int k = 0; k < 3; k++)
+	  adjacency[fill[indices[t * 3 + k]]++] = static_cast<unsigned int>(t);
+
+  std::vector<int> cachePosition(vertexCount, -1);
+  std::vector<float> score(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++)
+	score[v] = vertexScore(-1, remaining[v]);
+
+  std::vector<float> triangleScore(triangleCount);
+  for (size_t t = 0; t < triangleCount; t++)
+	triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+
+  std::vector<bool> emitted(triangleCount, false);
+  std::vector<unsigned int> result;
+  result.reserve(indices.size());
+  std::vector<unsigned int> cache;
+  std::vector<unsigned int> next;
+  size_t cursor = 0;
+
+  auto best = static_cast<size_t>(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+  for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+	// Nothing in the cache touches a live triangle, continue with the next unused one
+	if (best == triangleCount) {
+	  while (emitted[cursor])
+		cursor++;
+	  best = cursor;
+	}
+
+	emitted[best] = true;
+	const unsigned int *triangle = &indices[best * 3];
+	next.assign(triangle, triangle + 3);
+	for (int k = 0; k < 3; k++) {
+	  unsigned int v = triangle[k];
+	  result.push_back(v);
+
+	  // Drop the triangle from the vertex's live list
+	  auto begin = adjacency.begin() + offsets[v];
+	  auto end = begin + remaining[v];
+	  std::iter_swap(std::find(begin, end, static_cast<unsigned int>(best)), end - 1);
+	  remaining[v]--;
+	}
+
+	for (auto v : cache)
+	  if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+		next.push_back(v);
+
+	// Vertices pushed out of the modelled cache lose their position bonus
+	for (size_t i = SCORE_CACHE_SIZE; i < next.size(); i++) {
+	  cachePosition[next[i]] = -1;
+	  score[next[i]] = vertexScore(-1, remaining[next[i]]);
+	}
+	if (next.size() > SCORE_CACHE_SIZE)
+	  next.resize(SCORE_CACHE_SIZE);
+
+	for (size_t i = 0; i < next.size(); i++) {
+	  cachePosition[next[i]] = static_cast<int>(i);
+	  score[next[i]] = vertexScore(static_cast<int>(i), remaining[next[i]]);
+	}
+
+	// Only triangles around cached vertices changed score
+	best = triangleCount;
+	float bestScore = -1.0f;
+	for (auto v : next) {
+	  for (unsigned int i = offsets[v]; i < offsets[v] + remaining[v]; i++) {
+		unsigned int t = adjacency[i];
+		float s = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+		triangleScore[t] = s;
+		if (s > bestScore) {
+		  bestScore = s;
+		  best = t;
+		}
+	  }
+	}
+	cache.swap(next);
+  }
+
+  indices.swap(result);
+}
+
+auto MeshOptimizer::optimizeOverdraw(std::vector<unsigned int> &indices, const std::vector<Vertex> &vertices,
+									 float threshold) -> void {
+  size_t triangleCount = indices.size() / 3;
+  if (triangleCount < 2)
+	return;
+
+  float before = analyze(indices, vertices.size()).acmr;
+
+  // A cluster ends where the FIFO cache misses on all three corners, moving
+  // such a run around costs (almost) no extra transforms
+  std::vector<size_t> clusters{0};
+  std::vector<unsigned int> stamp(vertices.size(), 0);
+  unsigned int time = CACHE_SIZE + 1;
+  for (size_t t = 0; t < triangleCount; t++) {
+	int misses = 0;
+	for (int k = 0; k < 3; k++) {
+	  unsigned int index = indices[t * 3 + k];
+	  if (time - stamp[index] > CACHE_SIZE) {
+		stamp[index] = time++;
+		misses++;
+	  }
+	}
+	if (misses == 3 && t > clusters.back())
+	  clusters.push_back(t);
+  }
+  if (clusters.size() < 2)
+	return;
+  clusters.push_back(triangleCount);
+
+  glm::vec3 meshCentroid(0.0f);
+  for (auto &vertex : vertices)
+	meshCentroid += vertex.position;
+  meshCentroid /= float(vertices.size());
+
+  // Clusters facing away from the centre are likely to occlude the rest
+  std::vector<std::pair<float, size_t>> order;
+  for (size_t c = 0; c + 1 < clusters.size(); c++) {
+	glm::vec3 centroid(0.0f);
+	glm::vec3 normal(0.0f);
+	float area = 0.0f;
+	for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+	  auto &a = vertices[indices[t * 3]].position;
+	  auto &b = vertices[indices[t * 3 + 1]].position;
+	  auto &p = vertices[indices[t * 3 + 2]].position;
+	  glm::vec3 cross = glm::cross(b - a, p - a);
+	  float weight = glm::length(cross);
+	  centroid += (a + b + p) * (weight / 3.0f);
+	  normal += cross;
+	  area += weight;
+	}
+	if (area > 0.0f)
+	  centroid /= area;
+	float length = glm::length(normal);
+	float facing = length > 0.0f ? glm::dot(centroid - meshCentroid, normal / length) : 0.0f;
+	order.push_back({facing, c});
+  }
+  std::stable_sort(order.begin(), order.end(), [](auto &a, auto &b) { return a.first > b.first; });
+
+  std::vector<unsigned int> result;
+  result.reserve(indices.size());
+  for (auto &[facing, c] : order)
+	result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+
+  if (analyze(result, vertices.size()).acmr <= before * threshold)
+	indices.swap(result);
+}
+
+auto MeshOptimizer::optimizeVertexFetch(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices) -> void {
+  constexpr unsigned int UNUSED = ~0u;
+  std::vector<unsigned int> remap(vertices.size(), UNUSED);
+  std::vector<Vertex> ordered;
+  ordered.reserve(vertices.size());
+
+  for (auto &index : indices) {
+	if (remap[index] == UNUSED) {
+	  remap[index] = static_cast<unsigned int>(ordered.size());
+	  ordered.push_back(vertices[index]);
+	}
+	index = remap[index];
+  }
+
+  // Unreferenced vertices are dropped
+  vertices.swap(ordered);
+}
+
+auto MeshOptimizer::optimize(std::vector<Vertex> &vertices, std::vector<unsigned int> &indices,
+							 const std::string &name) -> void {
+  if (indices.size() < 3 || vertices.empty())
+	return;
+
+  size_t vertexCount = vertices.size();
+  auto before = analyze(indices, vertexCount);
+
+  weld(vertices, indices);
+  optimizeVertexCache(indices, vertices.size());
+  optimizeOverdraw(indices, vertices);
+  optimizeVertexFetch(vertices, indices);
+
+  auto after = analyze(indices, vertices.size());
+  std::cout << "[MeshOptimizer] " << name << ": vertices " << vertexCount << " -> " << vertices.size()
+			<< ", ACMR " << before.acmr << " -> " << after.acmr
+			<< ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+}
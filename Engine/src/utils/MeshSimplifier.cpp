@@ -0,0 +1,212 @@
+#include <utils/MeshSimplifier.h>
+#include <utils/MeshOptimizer.h>
+#include <geometry/Lod.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+using namespace omega::utils;
+using namespace omega::geometry;
+
+namespace {
+
+// Symmetric 4x4 error quadric, upper triangle, and the plane weight summed into it
+struct Quadric {
+  double a[10]{};
+  double weight{0.0};
+
+  auto addPlane(const glm::dvec3 &n, double d, double weight) -> void {
+	double p[4] = {n.x, n.y, n.z, d};
+	int k = 0;
+	for (int i = 0; i < 4; i++)
+	  for (int j = i; j < 4; j++)
+		a[k++] += weight * p[i] * p[j];
+	this->weight += weight;
+  }
+
+  auto operator+=(const Quadric &other) -> Quadric & {
+	for (int i = 0; i < 10; i++)
+	  a[i] += other.a[i];
+	weight += other.weight;
+	return *this;
+  }
+
+  auto error(const glm::vec3 &v) const -> double {
+	double x = v.x, y = v.y, z = v.z;
+	return a[0] * x * x + 2 * a[1] * x * y + 2 * a[2] * x * z + 2 * a[3] * x
+		+ a[4] * y * y + 2 * a[5] * y * z + 2 * a[6] * y
+		+ a[7] * z * z + 2 * a[8] * z
+		+ a[9];
+  }
+
+  // Weighted mean squared plane distance, independent of triangle area and mesh scale
+  auto distance(const glm::vec3 &v) const -> double {
+	return weight > 0.0 ? std::max(error(v) / weight, 0.0) : 0.0;
+  }
+};
+
+struct Collapse {
+  double cost;
+  unsigned int from;
+  unsigned int to;
+  unsigned int fromVersion;
+  unsigned int toVersion;
+
+  auto operator>(const Collapse &other) const -> bool { return cost > other.cost; }
+};
+
+auto edgeKey(unsigned int a, unsigned int b) -> uint64_t {
+  return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+}  // namespace
+
+auto MeshSimplifier::simplify(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices,
+							  size_t targetIndexCount, float maxError) -> std::vector<unsigned int> {
+  size_t triangleCount = indices.size() / 3;
+  std::vector<unsigned int> triangles(indices.begin(), indices.begin() + triangleCount * 3);
+  std::vector<bool> live(triangleCount, true);
+  size_t liveCount = triangleCount;
+
+  std::vector<Quadric> quadrics(vertices.size());
+  std::vector<std::vector<unsigned int>> adjacency(vertices.size());
+  std::unordered_map<uint64_t, int> edgeUse;
+  for (unsigned int t = 0; t < triangleCount; t++) {
+	const unsigned int *tri = &triangles[t * 3];
+	glm::dvec3 p0 = vertices[tri[0]].position, p1 = vertices[tri[1]].position, p2 = vertices[tri[2]].position;
+	glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+	double area = glm::length(n);
+	if (area > 0.0) {
+	  n /= area;
+	  for (int k = 0; k < 3; k++)
+		quadrics[tri[k]].addPlane(n, -glm::dot(n, p0), area);
+	}
+	for (int k = 0; k < 3; k++) {
+	  adjacency[tri[k]].push_back(t);
+	  edgeUse[edgeKey(tri[k], tri[(k + 1) % 3])]++;
+	}
+  }
+
+  // Edges with a single triangle are open borders or attribute seams
+  std::vector<bool> locked(vertices.size(), false);
+  for (auto &[key, uses] : edgeUse) {
+	if (uses == 1) {
+	  locked[key >> 32] = true;
+	  locked[key & 0xFFFFFFFFu] = true;
+	}
+  }
+
+  std::vector<unsigned int> version(vertices.size(), 0);
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+  auto push = [&](unsigned int a, unsigned int b) {
+	Quadric q = quadrics[a];
+	q += quadrics[b];
+	if (!locked[a])
+	  heap.push({q.distance(vertices[b].position), a, b, version[a], version[b]});
+	if (!locked[b])
+	  heap.push({q.distance(vertices[a].position), b, a, version[b], version[a]});
+  };
+  for (auto &[key, uses] : edgeUse)
+	push(static_cast<unsigned int>(key >> 32), static_cast<unsigned int>(key & 0xFFFFFFFFu));
+
+  // Collapsing must not turn any remaining triangle around
+  auto flips = [&](unsigned int from, unsigned int to) {
+	for (auto t : adjacency[from]) {
+	  const unsigned int *tri = &triangles[t * 3];
+	  if (!live[t] || tri[0] == to || tri[1] == to || tri[2] == to)
+		continue;
+	  glm::vec3 before[3], after[3];
+	  for (int k = 0; k < 3; k++) {
+		before[k] = vertices[tri[k]].position;
+		after[k] = tri[k] == from ? vertices[to].position : before[k];
+	  }
+	  glm::vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+	  glm::vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+	  if (glm::dot(n0, n1) <= 0.2f * glm::length(n0) * glm::length(n1))
+		return true;
+	}
+	return false;
+  };
+
+  // Costs are squared distances, maxError is a distance in model units
+  double maxCost = double(maxError) * double(maxError);
+  while (liveCount * 3 > targetIndexCount && !heap.empty()) {
+	auto collapse = heap.top();
+	heap.pop();
+	if (collapse.cost > maxCost)
+	  break;
+	if (version[collapse.from] != collapse.fromVersion || version[collapse.to] != collapse.toVersion)
+	  continue;
+	if (flips(collapse.from, collapse.to))
+	  continue;
+
+	unsigned int from = collapse.from;
+	unsigned int to = collapse.to;
+	quadrics[to] += quadrics[from];
+	for (auto t : adjacency[from]) {
+	  if (!live[t])
+		continue;
+	  unsigned int *tri = &triangles[t * 3];
+	  for (int k = 0; k < 3; k++)
+		if (tri[k] == from)
+		  tri[k] = to;
+	  if (tri[0] == tri[1] || tri[1] == tri[2] || tri[0] == tri[2]) {
+		live[t] = false;
+		liveCount--;
+	  } else {
+		adjacency[to].push_back(t);
+	  }
+	}
+	adjacency[from].clear();
+	version[from]++;
+	version[to]++;
+
+	// Costs around the surviving vertex changed
+	for (auto t : adjacency[to]) {
+	  if (!live[t])
+		continue;
+	  for (int k = 0; k < 3; k++)
+		if (triangles[t * 3 + k] != to)
+		  push(to, triangles[t * 3 + k]);
+	}
+  }
+
+  std::vector<unsigned int> result;
+  result.reserve(liveCount * 3);
+  for (size_t t = 0; t < triangleCount; t++)
+	if (live[t])
+	  result.insert(result.end(), triangles.begin() + t * 3, triangles.begin() + t * 3 + 3);
+  return result;
+}
+
+auto MeshSimplifier::buildLods(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices)
+-> std::vector<std::vector<unsigned int>> {
+  std::vector<std::vector<unsigned int>> lods;
+  if (indices.size() < MIN_LOD_INDICES || vertices.empty())
+	return lods;
+
+  glm::vec3 lo = vertices.front().position, hi = lo;
+  for (auto &vertex : vertices) {
+	lo = glm::min(lo, vertex.position);
+	hi = glm::max(hi, vertex.position);
+  }
+  float extent = glm::length(hi - lo);
+
+  // Each level halves the triangles, the error allowed grows with the distance it is used at
+  const float errors[MAX_LODS - 1] = {0.01f, 0.025f, 0.05f};
+  const std::vector<unsigned int> *previous = &indices;
+  for (int level = 0; level < MAX_LODS - 1; level++) {
+	auto lod = simplify(vertices, *previous, previous->size() / 2, errors[level] * extent);
+
+	// Locked seams or the error bound stopped it early, a near copy is not worth keeping
+	if (lod.empty() || lod.size() > previous->size() * 8 / 10)
+	  break;
+
+	MeshOptimizer::optimizeVertexCache(lod, vertices.size());
+	lods.push_back(std::move(lod));
+	previous = &lods.back();
+  }
+  return lods;
+}
@@ -3,6 +3,7 @@
 #include <render/CubeTexture.h>
 #include <geometry/SkyBox.h>
 #include <geometry/Object.h>
+#include <utils/PrimitiveCache.h>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -13,71 +14,58 @@ using namespace omega::render;
 
 auto ObjectGenerator::box(input::ObjectGenerator input)
 -> std::shared_ptr<geometry::Object> {
-  // set up vertex data (and buffer(s)) and configure vertex attributes
-  // ------------------------------------------------------------------
-  float vertices[] = {
-	  // positions          // normals           // texture coords
-	  -input.size, -input.size, -input.size, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f,
-	  -input.size, input.size, -input.size, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f,
-	  input.size, input.size, -input.size, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f,
-	  input.size, input.size, -input.size, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f,
-	  input.size, -input.size, -input.size, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
-	  -input.size, -input.size, -input.size, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f,
-
-	  -input.size, -input.size, input.size, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-	  input.size, -input.size, input.size, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f,
-	  input.size, input.size, input.size, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
-	  input.size, input.size, input.size, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
-	  -input.size, input.size, input.size, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f,
-	  -input.size, -input.size, input.size, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-
-	  -input.size, input.size, input.size, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
-	  -input.size, input.size, -input.size, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-	  -input.size, -input.size, -input.size, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
-	  -input.size, -input.size, -input.size, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
-	  -input.size, -input.size, input.size, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
-	  -input.size, input.size, input.size, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
-
-	  input.size, input.size, input.size, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // Start
-	  input.size, -input.size, input.size, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
-	  input.size, -input.size, -input.size, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
-	  input.size, -input.size, -input.size, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
-	  input.size, input.size, -input.size, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
-	  input.size, input.size, input.size, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
-
-	  -input.size, -input.size, -input.size, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f,
-	  input.size, -input.size, -input.size, 0.0f, -1.0f, 0.0f, 1.0f, 1.0f,
-	  input.size, -input.size, input.size, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-	  input.size, -input.size, input.size, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
-	  -input.size, -input.size, input.size, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f,
-	  -input.size, -input.size, -input.size, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f,
-
-	  -input.size, input.size, -input.size, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
-	  -input.size, input.size, input.size, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
-	  input.size, input.size, input.size, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
-	  input.size, input.size, input.size, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
-	  input.size, input.size, -input.size, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f,
-	  -input.size, input.size, -input.size, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f};
-
-  unsigned int VBO, cubeVAO;
-  glGenVertexArrays(1, &cubeVAO);
-  glGenBuffers(1, &VBO);
-
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-  glBindVertexArray(cubeVAO);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float),
-						(void *)(3*sizeof(float)));
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8*sizeof(float),
-						(void *)(6*sizeof(float)));
-  glEnableVertexAttribArray(2);
-
-  auto object = std::make_shared<Object>(cubeVAO, VBO, 36);
-
+  // Unit cube shared by every box, the size is applied as a scale
+  auto mesh = PrimitiveCache::instance()->mesh("box", [] {
+	float vertices[] = {
+		// positions          // normals           // texture coords
+		-1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f,
+		-1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 1.0f,
+		1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f,
+		1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 1.0f,
+		1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
+		-1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 1.0f, 0.0f,
+
+		-1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+		1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f,
+		1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+		1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f,
+		-1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f,
+		-1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+
+		-1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+		-1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+		-1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		-1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		-1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+		-1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+
+		1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, // Start
+		1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+		1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+		1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f,
+		1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+
+		-1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f,
+		1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 1.0f,
+		1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+		1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 1.0f, 0.0f,
+		-1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f,
+		-1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 1.0f,
+
+		-1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f,
+		-1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+		1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f,
+		1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f,
+		-1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f};
+	return PrimitiveCache::upload(vertices, sizeof(vertices), 36);
+  });
+
+  auto object = std::make_shared<Object>(mesh.vao, mesh.vbo, mesh.count);
+
+  object->setMeshScale(glm::vec3(input.size));
+  object->setBounds(Box3<float>(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f));
   object->setTextures(input.textures);
   object->setShader(input.shader);
   object->setName(input.name);
@@ -3,6 +3,7 @@
 #include <render/CubeTexture.h>
 #include <geometry/SkyBox.h>
 #include <geometry/Object.h>
+#include <utils/PrimitiveCache.h>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -19,71 +20,58 @@ auto ObjectGenerator::container(input::ObjectGenerator input)
   float containerSizeZ = input.size;
 
 
-  // set up vertex data (and buffer(s)) and configure vertex attributes
-  // ------------------------------------------------------------------
-  float vertices[] = {
-	  // positions          // normals           // texture coords
-	  -containerSizeX, -containerSizeY, -containerSizeZ, 0.0f, 0.0f, -1.0f, 0.761f, 0.0f,  // Left
-	  -containerSizeX, containerSizeY, -containerSizeZ, 0.0f, 0.0f, -1.0f, 0.761f, 0.326f,
-	  containerSizeX, containerSizeY, -containerSizeZ, 0.0f, 0.0f, -1.0f, 0.0f, 0.326f,
-	  containerSizeX, containerSizeY, -containerSizeZ, 0.0f, 0.0f, -1.0f, 0.0f, 0.326f,
-	  containerSizeX, -containerSizeY, -containerSizeZ, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
-	  -containerSizeX, -containerSizeY, -containerSizeZ, 0.0f, 0.0f, -1.0f, 0.761f, 0.0f,
-
-	  -containerSizeX, -containerSizeY, containerSizeZ, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,  // Side1
-	  containerSizeX, -containerSizeY, containerSizeZ, 0.0f, 0.0f, 1.0f, 0.761f, 0.0f,
-	  containerSizeX, containerSizeY, containerSizeZ, 0.0f, 0.0f, 1.0f, 0.761f, 0.326f,
-	  containerSizeX, containerSizeY, containerSizeZ, 0.0f, 0.0f, 1.0f, 0.761f, 0.326f,
-	  -containerSizeX, containerSizeY, containerSizeZ, 0.0f, 0.0f, 1.0f, 0.0f, 0.326f,
-	  -containerSizeX, -containerSizeY, containerSizeZ, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-
-	  -containerSizeX, containerSizeY, containerSizeZ, -1.0f, 0.0f, 0.0f, 0.33f, 1.0f,  // End
-	  -containerSizeX, containerSizeY, -containerSizeZ, -1.0f, 0.0f, 0.0f, 0.00f, 1.0f,
-	  -containerSizeX, -containerSizeY, -containerSizeZ, -1.0f, 0.0f, 0.0f, 0.00f, 0.649f,
-	  -containerSizeX, -containerSizeY, -containerSizeZ, -1.0f, 0.0f, 0.0f, 0.00f, 0.649f,
-	  -containerSizeX, -containerSizeY, containerSizeZ, -1.0f, 0.0f, 0.0f, 0.33f, 0.649f,
-	  -containerSizeX, containerSizeY, containerSizeZ, -1.0f, 0.0f, 0.0f, 0.33f, 1.0f,
-
-	  containerSizeX, containerSizeY, containerSizeZ, 1.0f, 0.0f, 0.0f, 0.33f, 1.0f, // Start
-	  containerSizeX, -containerSizeY, containerSizeZ, 1.0f, 0.0f, 0.0f, 0.33f, 0.649f,
-	  containerSizeX, -containerSizeY, -containerSizeZ, 1.0f, 0.0f, 0.0f, 0.657f, 0.649f,
-	  containerSizeX, -containerSizeY, -containerSizeZ, 1.0f, 0.0f, 0.0f, 0.657f, 0.649f,
-	  containerSizeX, containerSizeY, -containerSizeZ, 1.0f, 0.0f, 0.0f, 0.657f, 1.0f,
-	  containerSizeX, containerSizeY, containerSizeZ, 1.0f, 0.0f, 0.0f, 0.33f, 1.0f,
-
-	  -containerSizeX, -containerSizeY, -containerSizeZ, 0.0f, -1.0f, 0.0f, 0.0f, 0.326f, // Bottom
-	  containerSizeX, -containerSizeY, -containerSizeZ, 0.0f, -1.0f, 0.0f, 0.761f, 0.326f,
-	  containerSizeX, -containerSizeY, containerSizeZ, 0.0f, -1.0f, 0.0f, 0.761f, 0.649f,
-	  containerSizeX, -containerSizeY, containerSizeZ, 0.0f, -1.0f, 0.0f, 0.761f, 0.649f,
-	  -containerSizeX, -containerSizeY, containerSizeZ, 0.0f, -1.0f, 0.0f, 0.0f, 0.649f,
-	  -containerSizeX, -containerSizeY, -containerSizeZ, 0.0f, -1.0f, 0.0f, 0.0f, 0.326f,
-
-	  -containerSizeX, containerSizeY, -containerSizeZ, 0.0f, 1.0f, 0.0f, 0.0f, 0.326f, // Top
-	  -containerSizeX, containerSizeY, containerSizeZ, 0.0f, 1.0f, 0.0f, 0.0f, 0.649f,
-	  containerSizeX, containerSizeY, containerSizeZ, 0.0f, 1.0f, 0.0f, 0.761f, 0.649f,
-	  containerSizeX, containerSizeY, containerSizeZ, 0.0f, 1.0f, 0.0f, 0.761f, 0.649f,
-	  containerSizeX, containerSizeY, -containerSizeZ, 0.0f, 1.0f, 0.0f, 0.761f, 0.326f,
-	  -containerSizeX, containerSizeY, -containerSizeZ, 0.0f, 1.0f, 0.0f, 0.0f, 0.326f};
-
-  unsigned int VBO, cubeVAO;
-  glGenVertexArrays(1, &cubeVAO);
-  glGenBuffers(1, &VBO);
-
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-  glBindVertexArray(cubeVAO);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float),
-						(void *)(3*sizeof(float)));
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8*sizeof(float),
-						(void *)(6*sizeof(float)));
-  glEnableVertexAttribArray(2);
-
-  auto object = std::make_shared<Object>(cubeVAO, VBO, 36);
-
+  // Unit container shared by every instance, the proportions are applied as a scale
+  auto mesh = PrimitiveCache::instance()->mesh("container", [] {
+	float vertices[] = {
+		// positions          // normals           // texture coords
+		-1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.761f, 0.0f,  // Left
+		-1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.761f, 0.326f,
+		1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.326f,
+		1.0f, 1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.326f,
+		1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f,
+		-1.0f, -1.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.761f, 0.0f,
+
+		-1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,  // Side1
+		1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.761f, 0.0f,
+		1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.761f, 0.326f,
+		1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.761f, 0.326f,
+		-1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.326f,
+		-1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+
+		-1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.33f, 1.0f,  // End
+		-1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.00f, 1.0f,
+		-1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.00f, 0.649f,
+		-1.0f, -1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 0.00f, 0.649f,
+		-1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.33f, 0.649f,
+		-1.0f, 1.0f, 1.0f, -1.0f, 0.0f, 0.0f, 0.33f, 1.0f,
+
+		1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.33f, 1.0f, // Start
+		1.0f, -1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.33f, 0.649f,
+		1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.657f, 0.649f,
+		1.0f, -1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.657f, 0.649f,
+		1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 0.0f, 0.657f, 1.0f,
+		1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.33f, 1.0f,
+
+		-1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.326f, // Bottom
+		1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.761f, 0.326f,
+		1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.761f, 0.649f,
+		1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.761f, 0.649f,
+		-1.0f, -1.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.649f,
+		-1.0f, -1.0f, -1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.326f,
+
+		-1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.326f, // Top
+		-1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.649f,
+		1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.761f, 0.649f,
+		1.0f, 1.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.761f, 0.649f,
+		1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.761f, 0.326f,
+		-1.0f, 1.0f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.326f};
+	return PrimitiveCache::upload(vertices, sizeof(vertices), 36);
+  });
+
+  auto object = std::make_shared<Object>(mesh.vao, mesh.vbo, mesh.count);
+
+  object->setMeshScale(glm::vec3(containerSizeX, containerSizeY, containerSizeZ));
+  object->setBounds(Box3<float>(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f));
   object->setTextures(input.textures);
   object->setShader(input.shader);
   object->setName(input.name);
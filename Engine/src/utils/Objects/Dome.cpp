@@ -3,6 +3,7 @@
 #include <render/CubeTexture.h>
 #include <geometry/SkyBox.h>
 #include <geometry/Object.h>
+#include <utils/PrimitiveCache.h>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -13,40 +14,34 @@ using namespace omega::render;
 
 auto ObjectGenerator::dome(omega::input::CubeTextureInput input, float size)
 -> std::shared_ptr<omega::geometry::Object> {
-  float skyboxVertices[] = {
-	  // positions
-	  -size, size, -size, -size, -size, -size, size, -size, -size,
-	  size, -size, -size, size, size, -size, -size, size, -size,
+  // The sky box shader ignores the model matrix, so domes are shared per size
+  auto mesh = PrimitiveCache::instance()->mesh("dome:" + std::to_string(size), [size] {
+	float skyboxVertices[] = {
+		// positions
+		-size, size, -size, -size, -size, -size, size, -size, -size,
+		size, -size, -size, size, size, -size, -size, size, -size,
 
-	  -size, -size, size, -size, -size, -size, -size, size, -size,
-	  -size, size, -size, -size, size, size, -size, -size, size,
+		-size, -size, size, -size, -size, -size, -size, size, -size,
+		-size, size, -size, -size, size, size, -size, -size, size,
 
-	  size, -size, -size, size, -size, size, size, size, size,
-	  size, size, size, size, size, -size, size, -size, -size,
+		size, -size, -size, size, -size, size, size, size, size,
+		size, size, size, size, size, -size, size, -size, -size,
 
-	  -size, -size, size, -size, size, size, size, size, size,
-	  size, size, size, size, -size, size, -size, -size, size,
+		-size, -size, size, -size, size, size, size, size, size,
+		size, size, size, size, -size, size, -size, -size, size,
 
-	  -size, size, -size, size, size, -size, size, size, size,
-	  size, size, size, -size, size, size, -size, size, -size,
+		-size, size, -size, size, size, -size, size, size, size,
+		size, size, size, -size, size, size, -size, size, -size,
 
-	  -size, -size, -size, -size, -size, size, size, -size, -size,
-	  size, -size, -size, -size, -size, size, size, -size, size};
-
-  unsigned int skyboxVAO, skyboxVBO;
-  glGenVertexArrays(1, &skyboxVAO);
-  glGenBuffers(1, &skyboxVBO);
-  glBindVertexArray(skyboxVAO);
-  glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices,
-			   GL_STATIC_DRAW);
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), (void *)0);
+		-size, -size, -size, -size, -size, size, size, -size, -size,
+		size, -size, -size, -size, -size, size, size, -size, size};
+	return PrimitiveCache::upload(skyboxVertices, sizeof(skyboxVertices), 36, true);
+  });
 
   auto cubeTexture = std::make_shared<CubeTexture>();
   cubeTexture->load(input);
 
-  auto object = std::make_shared<SkyBox>(skyboxVAO, skyboxVBO, 36);
+  auto object = std::make_shared<SkyBox>(mesh.vao, mesh.vbo, mesh.count);
   object->addTexture(cubeTexture);
 
   return object;
@@ -1,8 +1,10 @@
 #include <utils/ObjectGenerator.h>
+#include <render/GLState.h>
 #include <render/Shader.h>
 #include <render/CubeTexture.h>
 #include <geometry/SkyBox.h>
 #include <geometry/Object.h>
+#include <geometry/VertexLayout.h>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -11,59 +13,93 @@ using namespace omega::utils;
 using namespace omega::geometry;
 using namespace omega::render;
 
+template <class T>
+static void upload(unsigned int target, unsigned int buffer, const std::vector<T> &data) {
+  glBindBuffer(target, buffer);
+  glBufferData(target, data.size()*sizeof(T), data.data(), GL_STATIC_DRAW);
+}
+
 auto ObjectGenerator::mesh(input::MeshInput input)
 -> std::shared_ptr<omega::geometry::Object> {
-  unsigned int VBO, EBO;
+  MeshBuffers buffers;
   unsigned int VAO;
-  
+
   if (input.flags & ogMirrorUV)
 	mirrorUV(input.vertices);
 
+  if (input.flags & ogCompactVertices)
+	buffers.format = (input.flags & ogNormalMap) ? VertexFormat::CompactTangent : VertexFormat::Compact;
+  buffers.vertices = static_cast<unsigned int>(input.vertices.size());
+
   glGenVertexArrays(1, &VAO);
-  glGenBuffers(1, &VBO);
-  glGenBuffers(1, &EBO);
+  glGenBuffers(streamCount(buffers.format), buffers.streams.data());
+  glGenBuffers(1, &buffers.ebo);
 
-  glBindVertexArray(VAO);
+  GLState::bindVertexArray(VAO);
   // load data into vertex buffers
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  // A great thing about structs is that their memory layout is sequential for
-  // all its items. The effect is that we can simply pass a pointer to the
-  // struct and it translates perfectly to a glm::vec3/2 array which again
-  // translates to 3/2 floats which translates to a byte array.
-  glBufferData(GL_ARRAY_BUFFER, input.vertices.size()*sizeof(Vertex),
-			   &input.vertices[0], GL_STATIC_DRAW);
-
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-  glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-			   input.indices.size()*sizeof(unsigned int), &input.indices[0],
-			   GL_STATIC_DRAW);
+  if (buffers.format==VertexFormat::Full) {
+	// A great thing about structs is that their memory layout is sequential for
+	// all its items. The effect is that we can simply pass a pointer to the
+	// struct and it translates perfectly to a glm::vec3/2 array which again
+	// translates to 3/2 floats which translates to a byte array.
+	upload(GL_ARRAY_BUFFER, buffers.streams[0], input.vertices);
+  } else {
+	std::vector<glm::vec3> positions;
+	std::vector<PackedSurface> surfaces;
+	std::vector<PackedTangent> tangents;
+	positions.reserve(input.vertices.size());
+	surfaces.reserve(input.vertices.size());
+	for (const auto &vertex : input.vertices) {
+	  positions.push_back(vertex.position);
+	  surfaces.push_back(packSurface(vertex));
+	  if (buffers.format==VertexFormat::CompactTangent)
+		tangents.push_back(packTangent(vertex));
+	}
+	upload(GL_ARRAY_BUFFER, buffers.streams[0], positions);
+	upload(GL_ARRAY_BUFFER, buffers.streams[1], surfaces);
+	if (buffers.format==VertexFormat::CompactTangent)
+	  upload(GL_ARRAY_BUFFER, buffers.streams[2], tangents);
+  }
+
+  // Coarser levels follow LOD 0 in the same index buffer
+  auto baseCount = static_cast<unsigned int>(input.indices.size());
+  std::vector<LodRange> lods;
+  for (auto &lod : input.lods) {
+	if (lods.size() + 1 >= MAX_LODS)
+	  break;
+	lods.push_back({static_cast<unsigned int>(input.indices.size()), static_cast<unsigned int>(lod.size())});
+	input.indices.insert(input.indices.end(), lod.begin(), lod.end());
+  }
+  buffers.indexCount = static_cast<unsigned int>(input.indices.size());
+
+  // 16-bit indices whenever every vertex can be addressed with them
+  if (input.vertices.size() < 0x10000) {
+	std::vector<uint16_t> indices(input.indices.begin(), input.indices.end());
+	buffers.indices = IndexType::U16;
+	upload(GL_ELEMENT_ARRAY_BUFFER, buffers.ebo, indices);
+  } else {
+	upload(GL_ELEMENT_ARRAY_BUFFER, buffers.ebo, input.indices);
+  }
 
   // set the vertex attribute pointers
-  // vertex Positions
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)0);
-  // vertex normals
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-						(void *)offsetof(Vertex, normal));
-  // vertex texture coords
-  glEnableVertexAttribArray(2);
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-						(void *)offsetof(Vertex, uv));
-  // vertex tangent
-  glEnableVertexAttribArray(3);
-  glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-						(void *)offsetof(Vertex, tangent));
-  // vertex bitangent
-  glEnableVertexAttribArray(4);
-  glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex),
-						(void *)offsetof(Vertex, bitangent));
-  glBindVertexArray(0);
-
-  auto object = std::make_shared<Object>(VAO, VBO, input.indices.size(),
-										 ObjectType::Elements);
+  setupVertexFormat(buffers.format, buffers.streams.data());
+  GLState::bindVertexArray(0);
+
+  auto object = std::make_shared<Object>(VAO, buffers.streams[0], baseCount, ObjectType::Elements);
+  object->setMeshBuffers(buffers);
+  object->setLods(lods);
   object->setName(input.name);
 
+  if (!input.bounds && !input.vertices.empty()) {
+	auto &first = input.vertices.front().position;
+	Box3<float> box(first.x, first.y, first.z, first.x, first.y, first.z);
+	for (const auto &vertex : input.vertices)
+	  box.extend(Point3<float>(vertex.position.x, vertex.position.y, vertex.position.z));
+	input.bounds = box;
+  }
+  if (input.bounds)
+	object->setBounds(input.bounds.value());
+
   for (const auto &[key, value] : input.textures) {
 	object->addTexture(value);
   }
@@ -3,6 +3,7 @@
 #include <render/CubeTexture.h>
 #include <geometry/SkyBox.h>
 #include <geometry/Object.h>
+#include <utils/PrimitiveCache.h>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -13,37 +14,24 @@ using namespace omega::render;
 
 auto ObjectGenerator::plane(input::ObjectGenerator input)
 -> std::shared_ptr<omega::geometry::Object> {
-  // set up vertex data (and buffer(s)) and configure vertex attributes
-  // ------------------------------------------------------------------
-  float vertices[] = {
-	  // positions          // normals           // texture coords
-	  -input.size, 0.f, -input.size, 0.0f, 1.0f, 0.0f, 0.0f, input
-		  .size, // Start
-	  -input.size, 0.f, input.size, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
-	  input.size, 0.f, input.size, 0.0f, 1.0f, 0.0f, input.size, 0.0f,
-	  input.size, 0.f, input.size, 0.0f, 1.0f, 0.0f, input.size, 0.0f,
-	  input.size, 0.f, -input.size, 0.0f, 1.0f, 0.0f, input.size, input.size,
-	  -input.size, 0.f, -input.size, 0.0f, 1.0f, 0.0f, 0.0f, input.size};
-
-  unsigned int VBO, cubeVAO;
-  glGenVertexArrays(1, &cubeVAO);
-  glGenBuffers(1, &VBO);
-
-  glBindBuffer(GL_ARRAY_BUFFER, VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-  glBindVertexArray(cubeVAO);
-  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float), (void *)0);
-  glEnableVertexAttribArray(0);
-  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float),
-						(void *)(3*sizeof(float)));
-  glEnableVertexAttribArray(1);
-  glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8*sizeof(float),
-						(void *)(6*sizeof(float)));
-  glEnableVertexAttribArray(2);
-
-  auto object = std::make_shared<Object>(cubeVAO, VBO, 6);
-
+  // Unit plane, the texture repeats once per unit of size so meshes are
+  // shared between planes of equal size
+  auto mesh = PrimitiveCache::instance()->mesh("plane:" + std::to_string(input.size), [&input] {
+	float vertices[] = {
+		// positions          // normals           // texture coords
+		-1.0f, 0.f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, input.size, // Start
+		-1.0f, 0.f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+		1.0f, 0.f, 1.0f, 0.0f, 1.0f, 0.0f, input.size, 0.0f,
+		1.0f, 0.f, 1.0f, 0.0f, 1.0f, 0.0f, input.size, 0.0f,
+		1.0f, 0.f, -1.0f, 0.0f, 1.0f, 0.0f, input.size, input.size,
+		-1.0f, 0.f, -1.0f, 0.0f, 1.0f, 0.0f, 0.0f, input.size};
+	return PrimitiveCache::upload(vertices, sizeof(vertices), 6);
+  });
+
+  auto object = std::make_shared<Object>(mesh.vao, mesh.vbo, mesh.count);
+
+  object->setMeshScale(glm::vec3(input.size, 1.0f, input.size));
+  object->setBounds(Box3<float>(-1.0f, 0.f, -1.0f, 1.0f, 0.f, 1.0f));
   object->setTextures(input.textures);
   object->setShader(input.shader);
   object->setName(input.name);
@@ -12,6 +12,7 @@
 #include <render/PointLight.h>
 #include <render/SpotLight.h>
 #include <render/Material.h>
+#include <render/OcclusionBuffer.h>
 #include <utils/ObjectGenerator.h>
 #include <utils/Loader.h>
 #include <nlohmann/json.hpp>
@@ -92,7 +93,7 @@ std::shared_ptr<Scene> PortalSceneLoader::loadFromString(const std::string& json
     // Set ambient
     if (json["scene"].contains("ambient")) {
       auto ambient = parseVec4(json["scene"], "ambient", glm::vec4(0.2f, 0.2f, 0.2f, 1.0f));
-      shader->setVec4("ambient", ambient.x, ambient.y, ambient.z, ambient.w);
+      scene->ambient(ambient);
     }
     
     // Parse objects
@@ -117,6 +118,10 @@ std::shared_ptr<Scene> PortalSceneLoader::loadFromString(const std::string& json
         portalRenderer->addPortalPair(portalPair);
       }
       portalRenderer->setMaxRecursionDepth(2);  // Default recursion depth
+      portalRenderer->setFramebufferSize(portalFramebufferSize_.x, portalFramebufferSize_.y);
+      portalRenderer->setUpdatePolicy(portalUpdate_);
+      portalRenderer->setMode(stencilPortals_ ? PortalRenderer::Mode::Stencil
+                                              : PortalRenderer::Mode::Texture);
       portalRenderer->setEnabled(true);
       scene->setPortalRenderer(portalRenderer);
     }
@@ -136,6 +141,19 @@ void PortalSceneLoader::parseScene(const nlohmann::json& json) {
   if (json.contains("name")) {
     // Could store scene name if Scene class supports it
   }
+
+  // Portal mode decides whether portals need framebuffers
+  stencilPortals_ = parseString(json, "portalMode", "texture") == "stencil";
+
+  // How often portal views are rendered again, every frame unless asked otherwise
+  if (json.contains("portalUpdate") && json["portalUpdate"].is_object()) {
+    const auto& update = json["portalUpdate"];
+    portalUpdate_.positionThreshold = parseFloat(update, "positionThreshold", portalUpdate_.positionThreshold);
+    portalUpdate_.angleThreshold = parseFloat(update, "angleThreshold", portalUpdate_.angleThreshold);
+    portalUpdate_.rectThreshold = parseFloat(update, "rectThreshold", portalUpdate_.rectThreshold);
+    portalUpdate_.refreshInterval = static_cast<int>(parseFloat(update, "refreshInterval", 1.0f));
+    portalUpdate_.viewBudget = static_cast<int>(parseFloat(update, "viewBudget", 0.0f));
+  }
 }
 
 void PortalSceneLoader::parseObjects(const nlohmann::json& json, Scene* scene,
@@ -171,6 +189,7 @@ void PortalSceneLoader::parseObjects(const nlohmann::json& json, Scene* scene,
     float size = parseFloat(objJson, "size", 0.5f);
     float mass = parseFloat(objJson, "mass", 1.0f);
     bool visible = parseBool(objJson, "visible", true);
+    bool occluder = parseBool(objJson, "occluder", false);
     
     // Get textures
     std::vector<std::shared_ptr<Texture>> objectTextures;
@@ -360,6 +379,12 @@ void PortalSceneLoader::parseObjects(const nlohmann::json& json, Scene* scene,
                 }
                 faceObject->setShader(shader);
                 faceObject->visible(visible);
+                if (occluder) {
+                  auto occluderMesh = std::make_shared<OccluderMesh>();
+                  for (const auto& v : vertices) occluderMesh->positions.push_back(v.position);
+                  occluderMesh->indices = faceIndices;
+                  faceObject->setOccluder(occluderMesh);
+                }
                 
                 // Parse physics for face object
                 if (objJson.contains("physics") && objJson["physics"].is_object()) {
@@ -436,6 +461,12 @@ void PortalSceneLoader::parseObjects(const nlohmann::json& json, Scene* scene,
                 object->setMaterial(material.value());
               }
               object->setShader(shader);
+              if (occluder) {
+                auto occluderMesh = std::make_shared<OccluderMesh>();
+                for (const auto& v : vertices) occluderMesh->positions.push_back(v.position);
+                occluderMesh->indices = indices;
+                object->setOccluder(occluderMesh);
+              }
             }
           }
         }
@@ -468,6 +499,11 @@ void PortalSceneLoader::parseObjects(const nlohmann::json& json, Scene* scene,
         modelMatrix = glm::translate(modelMatrix, position);
         
         object->setModel(modelMatrix);
+
+        // Generated shapes are their bounds, or lie flat inside them
+        if (occluder && object->hasBounds()) {
+          object->setOccluder(OccluderMesh::box(object->localBounds()));
+        }
       }
       
       // Parse physics
@@ -533,18 +569,15 @@ void PortalSceneLoader::parsePortals(const nlohmann::json& json) {
     portal->setEnabled(enabled);
     portal->setVisible(visible);
     
-    // Parse framebuffer settings
+    // Parse framebuffer settings, the largest size asked for caps the pooled
+    // targets sized to each portal's screen footprint. Stencil portals need none.
+    glm::ivec2 fbSize(1024, 1024);
     if (portalJson.contains("framebuffer") && portalJson["framebuffer"].is_object()) {
       auto fbJson = portalJson["framebuffer"];
-      int fbWidth = static_cast<int>(parseFloat(fbJson, "width", 1024.0f));
-      int fbHeight = static_cast<int>(parseFloat(fbJson, "height", 1024.0f));
-      auto framebuffer = std::make_shared<PortalFramebuffer>(fbWidth, fbHeight);
-      portal->setFramebuffer(framebuffer);
-    } else {
-      // Default framebuffer
-      auto framebuffer = std::make_shared<PortalFramebuffer>(1024, 1024);
-      portal->setFramebuffer(framebuffer);
+      fbSize.x = static_cast<int>(parseFloat(fbJson, "width", 1024.0f));
+      fbSize.y = static_cast<int>(parseFloat(fbJson, "height", 1024.0f));
     }
+    portalFramebufferSize_ = glm::max(portalFramebufferSize_, fbSize);
     
     portals_[id] = portal;
   }
@@ -661,6 +694,7 @@ void PortalSceneLoader::parseMaterials(const nlohmann::json& json) {
     
     Material material;
     material.shininess = parseFloat(materialJson, "shininess", 32.0f);
+    material.opacity = parseFloat(materialJson, "opacity", 1.0f);
     
     if (materialJson.contains("diffuse")) {
       auto diffuse = parseVec4(materialJson, "diffuse");
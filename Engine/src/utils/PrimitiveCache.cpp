@@ -0,0 +1,55 @@
+#include <utils/PrimitiveCache.h>
+#include <render/GLState.h>
+
+#include <glad/glad.h>
+
+using namespace omega::utils;
+
+static std::shared_ptr<PrimitiveCache> _cache;
+
+std::shared_ptr<PrimitiveCache> PrimitiveCache::instance() {
+  if (!_cache) {
+	_cache = std::make_shared<PrimitiveCache>();
+  }
+  return _cache;
+}
+
+auto PrimitiveCache::mesh(const std::string &key, const std::function<PrimitiveMesh()> &create) -> PrimitiveMesh {
+  auto it = meshes_.find(key);
+  if (it!=meshes_.end())
+	return it->second;
+
+  auto mesh = create();
+  meshes_[key] = mesh;
+  return mesh;
+}
+
+auto PrimitiveCache::upload(const float *vertices, size_t size, unsigned int count, bool positionsOnly)
+-> PrimitiveMesh {
+  PrimitiveMesh mesh;
+  mesh.count = count;
+
+  glGenVertexArrays(1, &mesh.vao);
+  glGenBuffers(1, &mesh.vbo);
+
+  render::GLState::bindVertexArray(mesh.vao);
+  glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+  glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+
+  if (positionsOnly) {
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), (void *)0);
+  } else {
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float), (void *)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8*sizeof(float),
+						  (void *)(3*sizeof(float)));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8*sizeof(float),
+						  (void *)(6*sizeof(float)));
+	glEnableVertexAttribArray(2);
+  }
+
+  render::GLState::bindVertexArray(0);
+  return mesh;
+}